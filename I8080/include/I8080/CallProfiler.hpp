@@ -0,0 +1,170 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef I8080_CALL_PROFILER_HPP_
+#define I8080_CALL_PROFILER_HPP_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace I8080
+{
+    /*!
+    \brief Attributes cycles to guest routines by following CALL,
+    RST and interrupt entry, and the returns which match them.
+    Returns are detected by the stack pointer moving past a
+    routine's return address, so routines which discard their
+    return address or reset the stack are handled too.
+    Driven by the CPU when its CallProfiling feature is enabled
+    */
+    class CallProfiler final
+    {
+    public:
+        /*!
+        \brief Totals for a single routine, identified by its
+        entry address. Inclusive cycles include the routines
+        called from this one, exclusive cycles do not
+        */
+        struct Routine final
+        {
+            std::uint64_t calls = 0;
+            std::uint64_t inclusive = 0;
+            std::uint64_t exclusive = 0;
+        };
+
+        CallProfiler();
+        ~CallProfiler() = default;
+
+        CallProfiler(const CallProfiler&) = delete;
+        CallProfiler& operator = (const CallProfiler&) = delete;
+
+        /*!
+        \brief Loads a symbol file used to name routines. Each line
+        holds an address and a label in either order, for example
+        '1400 DrawShiftedSprite' or 'DrawShiftedSprite EQU $1400'.
+        Text following ; or # is ignored
+        \returns false if the file couldn't be opened
+        */
+        bool loadSymbols(const std::string&);
+
+        /*!
+        \brief Clears all collected totals. Symbols are kept
+        */
+        void clear();
+
+        /*!
+        \brief Ends all active routines, for example when the
+        CPU is reset. Totals are kept
+        */
+        void unwind();
+
+        /*!
+        \brief Adds cycles to the active routine
+        */
+        void addCycles(std::int32_t cycles)
+        {
+            m_cycles += cycles;
+            m_nodes[m_frames.back().node].cycles += cycles;
+        }
+
+        /*!
+        \brief Enters the routine at the given address.
+        \param returnSP The stack pointer once the routine has returned
+        \param interrupt True if entered by an interrupt
+        */
+        void enter(std::uint16_t address, std::uint16_t returnSP, bool interrupt);
+
+        /*!
+        \brief Ends any routines whose return address lies
+        below the given stack pointer
+        */
+        void leave(std::uint16_t stackPointer)
+        {
+            while (m_frames.size() > 1 && stackPointer >= m_frames.back().returnSP)
+            {
+                pop();
+            }
+        }
+
+        /*!
+        \brief Returns the totals of each routine called at least
+        once, keyed by entry address. Interrupt entries are offset
+        by InterruptKey. Routines still active are included
+        */
+        std::map<std::uint32_t, Routine> getRoutines() const;
+
+        /*!
+        \brief Returns the symbol name for the given routine key,
+        or a name made from its address if there is none
+        */
+        std::string getName(std::uint32_t) const;
+
+        /*!
+        \brief Writes exclusive cycles in the folded stack format
+        read by flamegraph tools, one line per unique call stack
+        \returns false if the file couldn't be written
+        */
+        bool writeFoldedStacks(const std::string&) const;
+
+        /*!
+        \brief Writes the totals of each routine as CSV, ordered
+        by inclusive cycles
+        \returns false if the file couldn't be written
+        */
+        bool writeRoutines(const std::string&) const;
+
+        static constexpr std::uint32_t InterruptKey = 0x10000;
+
+    private:
+        //each unique call stack is a node in a tree
+        struct Node final
+        {
+            std::uint32_t key = 0;
+            std::uint32_t parent = 0;
+            std::uint64_t cycles = 0;
+        };
+        std::vector<Node> m_nodes;
+        std::unordered_map<std::uint64_t, std::uint32_t> m_children;
+
+        struct Frame final
+        {
+            std::uint32_t node = 0;
+            std::uint32_t returnSP = 0;
+            std::uint64_t entryCycles = 0;
+        };
+        std::vector<Frame> m_frames;
+
+        std::unordered_map<std::uint32_t, Routine> m_routines;
+        std::uint64_t m_cycles;
+
+        std::map<std::uint16_t, std::string> m_symbols;
+
+        void pop();
+        bool isActive(std::uint32_t key, std::size_t depth) const;
+    };
+}
+
+#endif //I8080_CALL_PROFILER_HPP_
\ No newline at end of file
@@ -0,0 +1,115 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef I8080_COVERAGE_MAP_HPP_
+#define I8080_COVERAGE_MAP_HPP_
+
+#include <I8080/OpInfo.hpp>
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+namespace I8080
+{
+    /*!
+    \brief Records which addresses have been executed, as a bitmap,
+    and how often each byte is read and written, as counters which
+    saturate at 255. Driven by the CPU when its Coverage feature
+    is enabled
+    */
+    class CoverageMap final
+    {
+    public:
+        static constexpr std::size_t Size = 0x10000;
+        static constexpr std::uint32_t HeatmapSize = 256; //!< width and height, one pixel per address
+
+        CoverageMap();
+        ~CoverageMap() = default;
+
+        CoverageMap(const CoverageMap&) = delete;
+        CoverageMap& operator = (const CoverageMap&) = delete;
+
+        void clear();
+
+        /*!
+        \brief Marks each byte of the instruction at the given address as executed
+        */
+        void addInstruction(std::uint16_t address, std::uint8_t length)
+        {
+            for (auto i = 0u; i < length; ++i)
+            {
+                m_executed[static_cast<std::uint16_t>(address + i)] = true;
+            }
+        }
+
+        /*!
+        \brief Counts the reads and writes of a decoded access
+        */
+        void addAccess(const MemoryAccess& access)
+        {
+            for (auto i = 0u; i < access.size; ++i)
+            {
+                const std::uint16_t address = access.address + i;
+                if (access.read) increment(m_reads[address]);
+                if (access.write) increment(m_writes[address]);
+            }
+        }
+
+        bool isExecuted(std::uint16_t address) const { return m_executed[address]; }
+        std::uint8_t getReadCount(std::uint16_t address) const { return m_reads[address]; }
+        std::uint8_t getWriteCount(std::uint16_t address) const { return m_writes[address]; }
+
+        struct Summary final
+        {
+            std::uint32_t executed = 0; //!< bytes executed
+            std::uint32_t read = 0; //!< bytes read at least once
+            std::uint32_t written = 0; //!< bytes written at least once
+        };
+
+        /*!
+        \brief Counts the bytes covered in the given range
+        */
+        Summary getSummary(std::uint16_t start, std::uint32_t size) const;
+
+        /*!
+        \brief Renders the map as RGBA pixels, one per address with
+        256 addresses to a row. Red shows writes, green reads and
+        blue executed code
+        */
+        void getHeatmap(std::vector<std::uint8_t>&) const;
+
+    private:
+        std::bitset<Size> m_executed;
+        std::array<std::uint8_t, Size> m_reads;
+        std::array<std::uint8_t, Size> m_writes;
+
+        static void increment(std::uint8_t& count)
+        {
+            count += (count != 0xFF);
+        }
+    };
+}
+
+#endif //I8080_COVERAGE_MAP_HPP_
\ No newline at end of file
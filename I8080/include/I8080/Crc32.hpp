@@ -0,0 +1,40 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef I8080_CRC32_HPP_
+#define I8080_CRC32_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace I8080
+{
+    /*!
+    \brief Calculates the CRC-32 (as used by zip and MAME) of the
+    given data. Pass a previous result to continue a checksum
+    over data which isn't contiguous
+    */
+    std::uint32_t crc32(const void* data, std::size_t size, std::uint32_t crc = 0);
+}
+
+#endif //I8080_CRC32_HPP_
\ No newline at end of file
@@ -0,0 +1,197 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef I8080_DEBUGGER_HPP_
+#define I8080_DEBUGGER_HPP_
+
+#include <I8080/OpInfo.hpp>
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace I8080
+{
+    /*!
+    \brief Breakpoints, watchpoints and stepping for the CPU.
+    While any of these are set the CPU runs a separate debug
+    instantiation of its loop, so the normal loop is unaffected.
+    When the CPU stops, CPU::update() returns early and executes
+    nothing more until the debugger is resumed or stepped
+    */
+    class Debugger final
+    {
+    public:
+        /*!
+        \brief Compared against the value read or written
+        */
+        enum class Condition
+        {
+            Any,
+            Equal,
+            NotEqual,
+            Changed //!< writes which change the value in memory
+        };
+
+        struct Watchpoint final
+        {
+            std::uint16_t address = 0;
+            std::uint16_t length = 1;
+            bool read = false;
+            bool write = true;
+            Condition condition = Condition::Any;
+            std::uint8_t value = 0;
+        };
+
+        enum class StopReason
+        {
+            None,
+            Breakpoint,
+            Watchpoint,
+            Step,
+            Break //!< requested with breakNow()
+        };
+
+        /*!
+        \brief Describes why and where the CPU stopped. For watch
+        points address and value are those of the access, and the
+        instruction which made it has already been executed
+        */
+        struct Stop final
+        {
+            StopReason reason = StopReason::None;
+            std::uint16_t programCounter = 0;
+            std::uint16_t address = 0;
+            std::uint8_t value = 0;
+            bool write = false;
+        };
+
+        static constexpr std::size_t HistorySize = 20;
+
+        Debugger();
+        ~Debugger() = default;
+
+        Debugger(const Debugger&) = delete;
+        Debugger& operator = (const Debugger&) = delete;
+
+        void addBreakpoint(std::uint16_t);
+        void removeBreakpoint(std::uint16_t);
+        bool hasBreakpoint(std::uint16_t address) const { return m_breakpoints[address]; }
+        void clearBreakpoints();
+
+        void addWatchpoint(const Watchpoint&);
+        void clearWatchpoints();
+
+        /*!
+        \brief Continues execution after a stop
+        */
+        void resume();
+        /*!
+        \brief Stops before the next instruction is executed
+        */
+        void breakNow();
+        /*!
+        \brief Executes a single instruction
+        */
+        void stepInto();
+        /*!
+        \brief Executes a single instruction, or if it's a call
+        runs until the call has returned
+        */
+        void stepOver();
+        /*!
+        \brief Runs until the current routine returns
+        */
+        void stepOut();
+
+        bool isStopped() const { return m_stop.reason != StopReason::None; }
+        const Stop& getStop() const { return m_stop; }
+
+        /*!
+        \brief Returns a one line description of the last stop
+        */
+        std::string getStopDescription() const;
+
+        /*!
+        \brief Returns the address of a recently executed
+        instruction, 0 being the most recent. Only recorded
+        while the debugger is active
+        */
+        std::uint16_t getHistory(std::size_t) const;
+
+        /*!
+        \brief True if the CPU needs to run its debug loop
+        */
+        bool isActive() const
+        {
+            return m_breakpointCount > 0 || !m_watchpoints.empty()
+                || m_step != Step::None || isStopped();
+        }
+
+        /*!
+        \brief Called by the CPU before executing an instruction
+        \returns false if the CPU should stop instead
+        */
+        bool canExecute(std::uint16_t programCounter, std::uint16_t stackPointer, std::uint8_t opcode);
+
+        /*!
+        \brief Called by the CPU after executing an instruction
+        \returns false if the CPU should stop
+        */
+        bool executed(const MemoryAccess&, const std::uint8_t* memory,
+            std::uint16_t programCounter, std::uint16_t stackPointer);
+
+    private:
+        std::bitset<0x10000> m_breakpoints;
+        std::size_t m_breakpointCount;
+        std::vector<Watchpoint> m_watchpoints;
+
+        enum class Step
+        {
+            None,
+            Into,
+            Over,
+            Out,
+            Break
+        }m_step;
+        bool m_stepStarted;
+        std::uint16_t m_stepPC;
+        std::uint16_t m_stepSP;
+        Flow m_lastFlow;
+
+        Stop m_stop;
+        bool m_ignoreBreakpoint; //so resuming from a breakpoint doesn't immediately stop again
+        std::uint16_t m_programCounter;
+
+        std::array<std::uint16_t, HistorySize> m_history;
+        std::size_t m_historyIndex;
+
+        void stop(StopReason);
+        void run(Step);
+        bool checkWatchpoints(const MemoryAccess&, const std::uint8_t*);
+    };
+}
+
+#endif //I8080_DEBUGGER_HPP_
\ No newline at end of file
@@ -0,0 +1,130 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef I8080_DISASSEMBLER_HPP_
+#define I8080_DISASSEMBLER_HPP_
+
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace I8080
+{
+    /*!
+    \brief Finds code by following control flow from the reset
+    and interrupt vectors, so data in the ROMs isn't mistaken
+    for instructions. Analysis is done on demand when the
+    disassembly is first queried, and continues incrementally
+    when entry points are added. Results are cached by the
+    checksum of the ROMs, so reloading a game reuses them.
+    Not thread safe.
+    */
+    class Disassembler final
+    {
+    public:
+        /*!
+        \brief An area of ROM. Only ROM is analysed since
+        the contents of RAM can change
+        */
+        struct Range final
+        {
+            std::uint16_t start = 0;
+            std::uint32_t size = 0;
+        };
+
+        Disassembler();
+        ~Disassembler() = default;
+
+        Disassembler(const Disassembler&) = delete;
+        Disassembler& operator = (const Disassembler&) = delete;
+
+        /*!
+        \brief Sets the memory to disassemble and the ROMs mapped
+        into it. The memory must outlive the disassembler
+        */
+        void setMemory(const std::uint8_t*, const std::vector<Range>&);
+
+        /*!
+        \brief Returns the CRC-32 of the ROMs, in the order given to setMemory()
+        */
+        std::uint32_t getChecksum() const { return m_checksum; }
+
+        /*!
+        \brief Adds an address known to be the start of an
+        instruction, such as a jump through HL or the current PC
+        */
+        void addEntryPoint(std::uint16_t);
+
+        /*!
+        \brief Returns true if the address is the start of an
+        instruction reached from an entry point
+        */
+        bool isCode(std::uint16_t);
+
+        /*!
+        \brief Returns the number of ROM bytes found to be code
+        */
+        std::size_t getCodeSize();
+
+        /*!
+        \brief Formats the instruction at the given address, or
+        a DB directive if the address isn't known to be code
+        \param length Set to the number of bytes formatted
+        */
+        std::string getLine(std::uint16_t address, std::uint16_t& length);
+
+        /*!
+        \brief Formats count lines starting at the given address
+        */
+        std::string getListing(std::uint16_t address, std::size_t count);
+
+        /*!
+        \brief Releases the results cached for every ROM set
+        */
+        static void clearCache();
+
+    private:
+        struct Analysis final
+        {
+            std::bitset<0x10000> code; //first byte of each instruction
+            std::bitset<0x10000> covered; //every byte of each instruction
+            std::vector<std::uint16_t> pending;
+        };
+        std::shared_ptr<Analysis> m_analysis;
+
+        using Cache = std::unordered_map<std::uint32_t, std::shared_ptr<Analysis>>;
+        static Cache& cache();
+
+        const std::uint8_t* m_memory;
+        std::vector<Range> m_roms;
+        std::uint32_t m_checksum;
+
+        bool isROM(std::uint32_t) const;
+        void analyse();
+    };
+}
+
+#endif //I8080_DISASSEMBLER_HPP_
\ No newline at end of file
@@ -0,0 +1,58 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef I8080_HOOKS_HPP_
+#define I8080_HOOKS_HPP_
+
+//these should only be defined within the I8080 CPU class
+//so including this elsewhere should result in nada.
+
+#ifdef HOOK_INCLUDE
+//runs the given number of iterations of a guest loop, all of which the
+//caller has checked fit in the cycle budget and within the loop count
+using HookRoutine = void (CPU::*)(std::uint32_t);
+
+struct Hook final
+{
+    Word address = 0; //head of the guest loop
+    Word exit = 0; //first instruction after the loop
+    std::int32_t cycles = 0; //per iteration
+    std::uint32_t instructions = 0; //per iteration
+    HookRoutine routine = nullptr;
+};
+std::vector<Hook> m_hooks;
+std::bitset<0x10000> m_hookAddresses;
+
+void installHooks(Word, std::uint32_t);
+void clearHooks();
+bool runHook(Word);
+void nextRow();
+
+//Space Invaders
+void drawShiftedSprite(std::uint32_t);
+void eraseSimpleSprite(std::uint32_t);
+void drawSimpleSprite(std::uint32_t);
+void blockCopy(std::uint32_t);
+#endif //HOOK_INCLUDE
+
+#endif //I8080_HOOKS_HPP_
\ No newline at end of file
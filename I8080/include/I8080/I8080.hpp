@@ -24,10 +24,19 @@ source distribution.
 #ifndef I8080_HPP_
 #define I8080_HPP_
 
+#include <I8080/CallProfiler.hpp>
+#include <I8080/CoverageMap.hpp>
+#include <I8080/Debugger.hpp>
+#include <I8080/Disassembler.hpp>
+#include <I8080/InstructionTrace.hpp>
+
 #include <cstdint>
 #include <string>
 #include <array>
+#include <bitset>
 #include <functional>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 using Byte = std::uint8_t;
@@ -35,8 +44,9 @@ using Word = std::uint16_t;
 
 namespace I8080
 {
-    constexpr std::uint16_t MEM_SIZE = 0xFFFF;
+    constexpr std::uint32_t MEM_SIZE = 0x10000;
     constexpr std::uint8_t  PORT_COUNT = 9;
+    constexpr std::uint16_t VRAM_SIZE = 0x1C00;
 
     /*!
     \brief Emulates the Intel 8080 CPU
@@ -59,6 +69,63 @@ namespace I8080
         */
         using OutputHandler = std::function<void(Byte, Byte)>;
 
+        /*!
+        \brief Optional instrumentation of the CPU loop, combined
+        as a bitmask. Each combination runs its own instantiation
+        of the loop, chosen once per update, so features which
+        are disabled cost nothing
+        */
+        enum Feature : std::uint32_t
+        {
+            Profiling = 0x1, //!< count executions, cycles and branches taken per opcode
+            CallProfiling = 0x2, //!< attribute cycles to guest routines, see CallProfiler
+            Debugging = 0x4, //!< set automatically while the Debugger is active
+            InstructionTracing = 0x8, //!< record every instruction to the file opened with openInstructionTrace()
+            Coverage = 0x10, //!< record executed addresses and memory access counts, see CoverageMap
+            HighLevel = 0x20, //!< run known ROM routines natively, see getHookCount()
+            Fusion = 0x40 //!< dispatch common runs of instructions as one, when no instrumentation is enabled
+        };
+        static constexpr std::uint32_t FeatureBits = 7;
+
+        /*!
+        \brief Counts collected per opcode when Profiling is enabled.
+        Taken and not taken are only counted for conditional jumps,
+        calls and returns
+        */
+        struct OpcodeStats final
+        {
+            std::uint64_t executions = 0;
+            std::uint64_t cycles = 0;
+            std::uint64_t taken = 0;
+            std::uint64_t notTaken = 0;
+        };
+
+        /*!
+        \brief Snapshot of everything needed to resume
+        emulation from a given point, including memory
+        */
+        struct State final
+        {
+            Byte a = 0;
+            Byte flags = 0;
+            Word bc = 0;
+            Word de = 0;
+            Word hl = 0;
+            Word programCounter = 0;
+            Word stackPointer = 0;
+
+            std::int32_t cycleCount = 0;
+            std::int32_t sliceCycles = 0;
+            std::uint64_t totalCycles = 0;
+            std::uint64_t instructionCount = 0;
+
+            Byte currentOpcode = 0;
+            bool interruptEnabled = false;
+            Byte interruptPending = 0;
+
+            std::array<Byte, MEM_SIZE> memory = {};
+        };
+
         CPU();
         ~CPU() = default;
 
@@ -85,16 +152,134 @@ namespace I8080
         */
         bool loadROM(const std::string&, Word, bool reset = true);
 
+        /*!
+        \brief Load a ROM image already read into memory, such as
+        one which has been checksummed, into the given address
+        */
+        bool loadROM(const std::vector<Byte>&, Word, bool reset = true);
+
         /*!
         \brief Outputs some info in a string
         */
         std::string getInfo() const;
 
+        /*!
+        \brief Returns the number of cycles executed since
+        the CPU was reset. When called from an input or output
+        handler this includes the cycles executed so far
+        in the current update.
+        */
+        std::uint64_t getCycleCount() const;
+
+        /*!
+        \brief Returns the number of instructions executed
+        since the CPU was reset
+        */
+        std::uint64_t getInstructionCount() const { return m_instructionCount; }
+
+        /*!
+        \brief Returns the address of the next instruction to execute
+        */
+        Word getProgramCounter() const { return m_registers.programCounter; }
+
+        /*!
+        \brief Returns the register pairs. Unlike saveState() these
+        are cheap enough to call from an input or output handler
+        */
+        Word getBC() const { return m_registers.BC; }
+        Word getDE() const { return m_registers.DE; }
+        Word getHL() const { return m_registers.HL; }
+
+        /*!
+        \brief Returns the byte at the given address
+        */
+        Byte readMemory(Word address) const { return m_memory[address]; }
+
+        /*!
+        \brief Returns the number of native routines installed for
+        the loaded ROMs. Each is matched by the checksum of its ROM
+        chip and the bytes of the guest routine, and only runs when
+        HighLevel is enabled without any instrumentation, which
+        needs to see every instruction
+        */
+        std::size_t getHookCount() const { return m_hooks.size(); }
+
         /*!
         \brief Returns a pointer to the start of VRAM
         */
         const Byte* getVRAM() const;
 
+        /*!
+        \brief Copies the current state of the CPU and memory
+        into the given State. Call between updates.
+        */
+        void saveState(State&) const;
+
+        /*!
+        \brief Restores a State previously saved with saveState()
+        */
+        void loadState(const State&);
+
+        /*!
+        \brief Sets the enabled Feature flags
+        */
+        void setFeatures(std::uint32_t);
+        std::uint32_t getFeatures() const { return m_features; }
+
+        const std::array<OpcodeStats, 256>& getOpcodeStats() const { return m_opcodeStats; }
+        void resetOpcodeStats();
+
+        /*!
+        \brief Writes the opcode stats as CSV
+        \returns false if the file couldn't be written
+        */
+        bool writeOpcodeStats(const std::string&) const;
+
+        /*!
+        \brief Writes the execution counts of each pair and triple of
+        instructions which ran one after the other without branching,
+        as CSV sorted by cycles. Collected with Profiling, these are the
+        candidates for Fusion
+        \returns false if the file couldn't be written
+        */
+        bool writeSequenceStats(const std::string&) const;
+
+        /*!
+        \brief Returns the call profiler, which collects
+        data while CallProfiling is enabled
+        */
+        CallProfiler& getCallProfiler() { return m_callProfiler; }
+        const CallProfiler& getCallProfiler() const { return m_callProfiler; }
+
+        /*!
+        \brief Returns the coverage map, which collects
+        data while Coverage is enabled
+        */
+        CoverageMap& getCoverage() { return m_coverage; }
+        const CoverageMap& getCoverage() const { return m_coverage; }
+
+        /*!
+        \brief Opens a file to which the state before each
+        instruction is written while InstructionTracing is
+        enabled. See TraceWriter for the format
+        \returns false if the file couldn't be opened
+        */
+        bool openInstructionTrace(const std::string& path) { return m_traceWriter.open(path); }
+        void closeInstructionTrace() { m_traceWriter.close(); }
+
+        /*!
+        \brief Returns the debugger. The CPU switches to its debug
+        loop whenever breakpoints, watchpoints or a step are set
+        */
+        Debugger& getDebugger() { return m_debugger; }
+        const Debugger& getDebugger() const { return m_debugger; }
+
+        /*!
+        \brief Returns the disassembler for the loaded ROMs, seeded
+        with the reset vector and any interrupt vectors raised so far
+        */
+        Disassembler& getDisassembler();
+
         /*!
         \brief Sets the input handling function
         */
@@ -105,15 +290,27 @@ namespace I8080
         */
         void setOutputHandler(const OutputHandler& oh) { handleOutput = oh; }
 
-#ifdef DEBUG_TOOLS
-        void disassemble();
-#endif //DEBUG_TOOLS
-
     private:
 
         using Opcode = void (CPU::*)();
         std::array<Opcode, 256> m_opcodes;
 
+        //runs of two or three instructions executed by a single handler,
+        //indexed by the first opcode. Runs sharing a first opcode are
+        //tried in the order they were added, so longer ones go first
+        struct FusedSequence final
+        {
+            Opcode handler = nullptr;
+            std::array<Byte, 2> following = {}; //opcodes after the first
+            std::array<Byte, 2> offsets = {}; //of each from the first
+            Byte count = 0; //of following opcodes
+            std::int32_t cycles = 0; //of all but the last instruction
+        };
+        static constexpr std::size_t FusionCandidates = 2;
+        std::array<std::array<FusedSequence, FusionCandidates>, 256> m_fusedSequences;
+        Opcode findFusedSequence(Word) const;
+        bool storesIntoRun(Word, Word) const;
+
         struct Registers final
         {
         public:
@@ -168,6 +365,46 @@ namespace I8080
         }m_flags;
 
         std::int32_t m_cycleCount;
+        std::int32_t m_sliceCycles; //cycles requested by current update
+        std::uint64_t m_totalCycles;
+        std::uint64_t m_instructionCount;
+
+        //the CPU loop, instantiated for each combination of features
+        template <std::uint32_t Mode>
+        void execute();
+        using Executor = void (CPU::*)();
+        template <std::size_t... Modes>
+        static std::array<Executor, sizeof...(Modes)> makeExecutors(std::index_sequence<Modes...>);
+        Executor m_executor;
+        Executor m_debugExecutor;
+        std::uint32_t m_features;
+
+        std::array<OpcodeStats, 256> m_opcodeStats;
+        void updateOpcodeStats(Word, Word);
+
+        //the opcodes of the last three instructions, oldest in the
+        //high byte, counted while each fell through to the next
+        std::uint32_t m_sequence;
+        std::uint32_t m_sequenceLength;
+        Word m_sequenceAddress;
+        std::unordered_map<std::uint32_t, std::uint64_t> m_sequenceCounts;
+        void updateSequenceStats(Word);
+
+        CallProfiler m_callProfiler;
+        void updateCallProfiler(Word);
+
+        Debugger m_debugger;
+
+        CoverageMap m_coverage;
+
+        Disassembler m_disassembler;
+        std::vector<Disassembler::Range> m_romRanges;
+        bool m_romsChanged;
+        Byte m_interruptVectors; //one bit for each vector raised since reset
+
+        TraceWriter m_traceWriter;
+        void writeTraceRecord();
+        MemoryAccess getMemoryAccess() const;
 
         Byte m_currentOpcode;
         std::array<Byte, MEM_SIZE> m_memory;
@@ -191,38 +428,16 @@ namespace I8080
 #include <I8080/Opcodes.hpp>
 #undef OP_INCLUDE
 
+        //native versions of known ROM routines
+#define HOOK_INCLUDE
+#include <I8080/Hooks.hpp>
+#undef HOOK_INCLUDE
+
         //unit tests for opcodes
 #ifdef OP_TEST
 #include <I8080/OpTests.hpp>
 #endif // OP_TEST
 
-#ifdef DEBUG_TOOLS
-        struct Dasm final
-        {
-            enum class Type
-            {
-                Opcode,
-                Operand
-            };
-            
-            std::string mnem;
-            Byte operand0 = 0;
-            Byte operand1 = 0;
-            Type type = Type::Opcode;
-        };
-        std::vector<Dasm> m_disassembly;
-
-        class RBuff final
-        {
-        public:
-            void push(Word);
-            Word operator [](std::size_t) const;
-        private:
-            std::array<Word, 20> m_buff;
-            std::size_t m_idx = 0;
-        }m_callstack;
-#endif //DEBUG_TOOLS
-
     };
 }
 #endif //I8080_HPP_
\ No newline at end of file
@@ -0,0 +1,199 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef I8080_INSTRUCTION_TRACE_HPP_
+#define I8080_INSTRUCTION_TRACE_HPP_
+
+#include <I8080/OpInfo.hpp>
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace I8080
+{
+    /*!
+    \brief The CPU state recorded before each instruction is executed
+    */
+    struct TraceRecord final
+    {
+        std::uint64_t cycle = 0; //!< cycles executed since reset
+        std::uint16_t programCounter = 0;
+        std::uint16_t stackPointer = 0;
+        std::uint16_t bc = 0;
+        std::uint16_t de = 0;
+        std::uint16_t hl = 0;
+        std::uint8_t a = 0;
+        std::uint8_t flags = 0;
+        std::uint8_t opcode = 0;
+    };
+
+    /*!
+    \brief Streams TraceRecords to a file. Each record is delta
+    encoded against the previous one: a mask byte and the opcode,
+    followed by only the registers which changed. The PC is only
+    stored when it isn't the address following the previous
+    instruction, and the cycle count only when the previous
+    opcode took a different number of cycles than it did last
+    time, so most instructions take 3 or 4 bytes
+    */
+    class TraceWriter final
+    {
+    public:
+        TraceWriter();
+        ~TraceWriter();
+
+        TraceWriter(const TraceWriter&) = delete;
+        TraceWriter& operator = (const TraceWriter&) = delete;
+
+        /*!
+        \brief Opens a file to write to, replacing any existing file
+        \returns false if the file couldn't be opened
+        */
+        bool open(const std::string&);
+        /*!
+        \brief Flushes any buffered records and closes the file
+        */
+        void close();
+        bool isOpen() const { return m_file.is_open(); }
+
+        /*!
+        \brief Appends a record
+        */
+        void write(const TraceRecord& record)
+        {
+            std::uint8_t mask = 0;
+            auto* dst = m_buffer.data() + m_size + 2;
+
+            if (record.a != m_last.a) { mask |= 0x01; *dst++ = record.a; }
+            if (record.flags != m_last.flags) { mask |= 0x02; *dst++ = record.flags; }
+            if (record.bc != m_last.bc) { mask |= 0x04; dst = writeWord(dst, record.bc); }
+            if (record.de != m_last.de) { mask |= 0x08; dst = writeWord(dst, record.de); }
+            if (record.hl != m_last.hl) { mask |= 0x10; dst = writeWord(dst, record.hl); }
+            if (record.stackPointer != m_last.stackPointer) { mask |= 0x20; dst = writeWord(dst, record.stackPointer); }
+            if (record.programCounter != nextProgramCounter()) { mask |= 0x40; dst = writeWord(dst, record.programCounter); }
+
+            const auto cycles = record.cycle - m_last.cycle;
+            if (cycles != m_opcodeCycles[m_last.opcode])
+            {
+                mask |= 0x80;
+                m_opcodeCycles[m_last.opcode] = cycles;
+                dst = writeVarint(dst, cycles);
+            }
+
+            m_buffer[m_size] = mask;
+            m_buffer[m_size + 1] = record.opcode;
+            m_size = dst - m_buffer.data();
+            m_last = record;
+
+            if (m_size > m_buffer.size() - MaxRecordSize)
+            {
+                flush();
+            }
+        }
+
+        /*!
+        \brief Largest possible encoded record, in bytes
+        */
+        static constexpr std::size_t MaxRecordSize = 2 + 2 + 8 + 10;
+
+    private:
+        std::ofstream m_file;
+        std::vector<std::uint8_t> m_buffer;
+        std::size_t m_size;
+
+        TraceRecord m_last;
+        std::array<std::uint64_t, 256> m_opcodeCycles;
+
+        std::uint16_t nextProgramCounter() const
+        {
+            return static_cast<std::uint16_t>(m_last.programCounter + opInfo[m_last.opcode].length);
+        }
+
+        static std::uint8_t* writeWord(std::uint8_t* dst, std::uint16_t word)
+        {
+            *dst++ = word & 0xFF;
+            *dst++ = word >> 8;
+            return dst;
+        }
+
+        static std::uint8_t* writeVarint(std::uint8_t* dst, std::uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                *dst++ = static_cast<std::uint8_t>(value | 0x80);
+                value >>= 7;
+            }
+            *dst++ = static_cast<std::uint8_t>(value);
+            return dst;
+        }
+
+        void flush();
+    };
+
+    /*!
+    \brief Reads the records of a file written with TraceWriter
+    */
+    class TraceReader final
+    {
+    public:
+        TraceReader();
+        ~TraceReader() = default;
+
+        TraceReader(const TraceReader&) = delete;
+        TraceReader& operator = (const TraceReader&) = delete;
+
+        /*!
+        \brief Opens a trace file
+        \returns false if the file couldn't be opened or isn't a trace
+        */
+        bool open(const std::string&);
+
+        /*!
+        \brief Reads the next record
+        \returns false at the end of the trace
+        */
+        bool next(TraceRecord&);
+
+        /*!
+        \brief Returns the number of records read so far
+        */
+        std::uint64_t getCount() const { return m_count; }
+
+    private:
+        std::ifstream m_file;
+        std::vector<std::uint8_t> m_buffer;
+        std::size_t m_position;
+        std::size_t m_size;
+        std::uint64_t m_count;
+
+        TraceRecord m_last;
+        std::array<std::uint64_t, 256> m_opcodeCycles;
+
+        bool fill();
+    };
+}
+
+#endif //I8080_INSTRUCTION_TRACE_HPP_
\ No newline at end of file
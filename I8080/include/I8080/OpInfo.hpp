@@ -0,0 +1,107 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef I8080_OPINFO_HPP_
+#define I8080_OPINFO_HPP_
+
+#include <array>
+#include <cstdint>
+
+namespace I8080
+{
+    /*!
+    \brief How an instruction affects the flow of the program
+    */
+    enum class Flow
+    {
+        None,
+        Jump,
+        CondJump,
+        Call,
+        CondCall,
+        Return,
+        CondReturn,
+        Restart,
+        Halt
+    };
+
+    /*!
+    \brief Data memory accessed by an instruction, and the
+    register or operand holding its address. Instruction
+    fetches are not included. Stack accesses are a word
+    */
+    enum class Access
+    {
+        None,
+        ReadHL,
+        WriteHL,
+        ModifyHL, //!< read then written, eg INR M
+        ReadBC,
+        WriteBC,
+        ReadDE,
+        WriteDE,
+        ReadDirect, //!< byte at the a16 operand
+        WriteDirect,
+        ReadDirectWord, //!< word at the a16 operand
+        WriteDirectWord,
+        Push, //!< word below SP
+        Pop, //!< word at SP
+        ExchangeStack //!< word at SP, read then written
+    };
+
+    /*!
+    \brief Static properties of each opcode. Mnemonics use d8,
+    d16 and a16 as placeholders for immediate operands.
+    Undocumented opcodes are prefixed with *
+    */
+    struct OpInfo final
+    {
+        const char* mnemonic;
+        std::uint8_t length; //!< in bytes, including the opcode
+        Flow flow;
+        Access access;
+    };
+
+    extern const std::array<OpInfo, 256> opInfo;
+
+    /*!
+    \brief Number of cycles taken by each opcode. Conditional
+    calls and returns are charged the same whether taken or not
+    */
+    extern const std::array<std::uint8_t, 256> opCycles;
+
+    /*!
+    \brief Memory accessed by a single instruction, decoded
+    from its Access by the CPU before it is executed
+    */
+    struct MemoryAccess final
+    {
+        std::uint16_t address = 0;
+        std::uint8_t size = 0; //!< 0 if no memory is accessed
+        bool read = false;
+        bool write = false;
+        std::array<std::uint8_t, 2> before = {}; //!< the value before the instruction was executed
+    };
+}
+
+#endif //I8080_OPINFO_HPP_
\ No newline at end of file
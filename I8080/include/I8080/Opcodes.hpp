@@ -104,9 +104,9 @@ void cmpa(); void cmpb(); void cmpc(); void cmpd(); void cmpe(); void cmph(); vo
 //jump
 void jmp(); void jnz(); void jz(); void jnc(); void jc(); void jpo(); void jpe(); void jp(); void jm(); void pchl();
 //call
-void inline call(); void cnz(); void cz(); void cnc(); void cc(); void cpo(); void cpe(); void cp(); void cm();
+void call(); void cnz(); void cz(); void cnc(); void cc(); void cpo(); void cpe(); void cp(); void cm();
 //return
-void inline ret(); void rnz(); void rz(); void rnc(); void rc(); void rpo(); void rpe(); void rp(); void rm();
+void ret(); void rnz(); void rz(); void rnc(); void rc(); void rpo(); void rpe(); void rp(); void rm();
 //RST
 void inline rst();
 void rst0(); void rst1(); void rst2(); void rst3(); void rst4(); void rst5(); void rst6(); void rst7();
@@ -120,6 +120,11 @@ void in(); void out();
 //16 bit transfer immediate instructions
 void mvia(); void mvib(); void mvic(); void mvid(); void mvie(); void mvih(); void mvil(); void mvim();
 
+//fused sequences, see m_fusedSequences
+void inline retire(Byte);
+void lxibDadbPopb(); void outInOram(); void movmaInxhInxd(); void movmaInxh();
+void dcrbJnz(); void pushbPushh(); void ldaxdMovma(); void inxhInxd();
+
 #endif //OP_INCLUDE
 
 #endif //I8080_OP_HPP_
\ No newline at end of file
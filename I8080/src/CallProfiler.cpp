@@ -0,0 +1,277 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <I8080/CallProfiler.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace I8080;
+
+namespace
+{
+    //guards against runaway growth if the guest
+    //calls without ever returning
+    const std::size_t maxDepth = 256;
+
+    const std::uint32_t rootKey = 0xFFFFFFFF;
+
+    bool parseAddress(std::string str, std::uint16_t& dst)
+    {
+        if (str.size() > 1 && str[0] == '$')
+        {
+            str = str.substr(1);
+        }
+        else if (str.size() > 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X'))
+        {
+            str = str.substr(2);
+        }
+        else if (str.size() > 1 && (str.back() == 'h' || str.back() == 'H'))
+        {
+            str.pop_back();
+        }
+
+        if (str.empty() || str.size() > 4
+            || str.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos)
+        {
+            return false;
+        }
+        dst = static_cast<std::uint16_t>(std::stoul(str, nullptr, 16));
+        return true;
+    }
+}
+
+constexpr std::uint32_t CallProfiler::InterruptKey;
+
+CallProfiler::CallProfiler()
+    : m_cycles(0)
+{
+    clear();
+}
+
+//public
+bool CallProfiler::loadSymbols(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file.good()) return false;
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        line = line.substr(0, line.find_first_of(";#"));
+        std::replace(line.begin(), line.end(), ':', ' ');
+        std::replace(line.begin(), line.end(), '=', ' ');
+
+        std::vector<std::string> tokens;
+        std::stringstream ss(line);
+        std::string token;
+        while (ss >> token)
+        {
+            if (token != "EQU" && token != "equ")
+            {
+                tokens.push_back(token);
+            }
+        }
+        if (tokens.size() != 2) continue;
+
+        std::uint16_t address = 0;
+        if (parseAddress(tokens[0], address))
+        {
+            m_symbols[address] = tokens[1];
+        }
+        else if (parseAddress(tokens[1], address))
+        {
+            m_symbols[address] = tokens[0];
+        }
+    }
+    return true;
+}
+
+void CallProfiler::clear()
+{
+    m_nodes.clear();
+    m_nodes.emplace_back();
+    m_nodes.back().key = rootKey;
+    m_children.clear();
+    m_routines.clear();
+    m_cycles = 0;
+
+    m_frames.clear();
+    m_frames.emplace_back();
+    m_frames.back().returnSP = rootKey;
+}
+
+void CallProfiler::unwind()
+{
+    while (m_frames.size() > 1)
+    {
+        pop();
+    }
+}
+
+void CallProfiler::enter(std::uint16_t address, std::uint16_t returnSP, bool interrupt)
+{
+    if (m_frames.size() > maxDepth) return;
+
+    const std::uint32_t key = address + (interrupt ? InterruptKey : 0);
+    const auto parent = m_frames.back().node;
+
+    //node ID is looked up from the parent and key
+    const auto id = (static_cast<std::uint64_t>(parent) << 32) | key;
+    auto result = m_children.find(id);
+    if (result == m_children.end())
+    {
+        Node node;
+        node.key = key;
+        node.parent = parent;
+        m_nodes.push_back(node);
+        result = m_children.insert(std::make_pair(id, static_cast<std::uint32_t>(m_nodes.size() - 1))).first;
+    }
+
+    Frame frame;
+    frame.node = result->second;
+    frame.returnSP = returnSP;
+    frame.entryCycles = m_cycles;
+    m_frames.push_back(frame);
+
+    m_routines[key].calls++;
+}
+
+std::map<std::uint32_t, CallProfiler::Routine> CallProfiler::getRoutines() const
+{
+    std::map<std::uint32_t, Routine> routines(m_routines.begin(), m_routines.end());
+
+    //exclusive cycles are the sum of every node belonging to the routine
+    for (auto i = 1u; i < m_nodes.size(); ++i)
+    {
+        routines[m_nodes[i].key].exclusive += m_nodes[i].cycles;
+    }
+
+    //routines which haven't returned yet, such as a main loop
+    for (auto i = 1u; i < m_frames.size(); ++i)
+    {
+        const auto key = m_nodes[m_frames[i].node].key;
+        if (!isActive(key, i))
+        {
+            routines[key].inclusive += m_cycles - m_frames[i].entryCycles;
+        }
+    }
+    return routines;
+}
+
+std::string CallProfiler::getName(std::uint32_t key) const
+{
+    if (key == rootKey) return "root";
+
+    const auto address = static_cast<std::uint16_t>(key);
+    const auto result = m_symbols.find(address);
+    if (result != m_symbols.end())
+    {
+        return result->second;
+    }
+
+    char name[12];
+    std::snprintf(name, sizeof(name), (key & InterruptKey) ? "isr_%04X" : "sub_%04X", address);
+    return name;
+}
+
+bool CallProfiler::writeFoldedStacks(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file.good()) return false;
+
+    std::vector<std::string> names;
+    for (auto i = 0u; i < m_nodes.size(); ++i)
+    {
+        if (m_nodes[i].cycles == 0) continue;
+
+        names.clear();
+        for (auto node = i; node != 0; node = m_nodes[node].parent)
+        {
+            names.push_back(getName(m_nodes[node].key));
+        }
+
+        file << getName(rootKey);
+        for (auto name = names.rbegin(); name != names.rend(); ++name)
+        {
+            file << ";" << *name;
+        }
+        file << " " << m_nodes[i].cycles << "\n";
+    }
+    return file.good();
+}
+
+bool CallProfiler::writeRoutines(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file.good()) return false;
+
+    const auto routines = getRoutines();
+    std::vector<std::pair<std::uint32_t, Routine>> sorted(routines.begin(), routines.end());
+    std::sort(sorted.begin(), sorted.end(),
+        [](const std::pair<std::uint32_t, Routine>& a, const std::pair<std::uint32_t, Routine>& b)
+    {
+        return a.second.inclusive > b.second.inclusive;
+    });
+
+    file << "address,name,interrupt,calls,inclusive_cycles,exclusive_cycles,inclusive_percent,exclusive_percent\n";
+    for (const auto& routine : sorted)
+    {
+        const auto& totals = routine.second;
+        const auto inclusive = (m_cycles > 0) ? (100.0 * totals.inclusive) / m_cycles : 0.0;
+        const auto exclusive = (m_cycles > 0) ? (100.0 * totals.exclusive) / m_cycles : 0.0;
+
+        char address[8];
+        std::snprintf(address, sizeof(address), "0x%04X", routine.first & 0xFFFF);
+        file << address << "," << getName(routine.first) << ","
+            << ((routine.first & InterruptKey) ? 1 : 0) << "," << totals.calls << ","
+            << totals.inclusive << "," << totals.exclusive << ","
+            << inclusive << "," << exclusive << "\n";
+    }
+    return file.good();
+}
+
+//private
+void CallProfiler::pop()
+{
+    const auto& frame = m_frames.back();
+    const auto key = m_nodes[frame.node].key;
+
+    //recursive calls are only counted once, by the outermost
+    if (!isActive(key, m_frames.size() - 1))
+    {
+        m_routines[key].inclusive += m_cycles - frame.entryCycles;
+    }
+    m_frames.pop_back();
+}
+
+bool CallProfiler::isActive(std::uint32_t key, std::size_t depth) const
+{
+    for (auto i = 1u; i < depth; ++i)
+    {
+        if (m_nodes[m_frames[i].node].key == key) return true;
+    }
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <I8080/CoverageMap.hpp>
+
+using namespace I8080;
+
+namespace
+{
+    //anything touched at all is clearly visible,
+    //brightening as the counts approach saturation
+    std::uint8_t getIntensity(std::uint8_t count)
+    {
+        return (count == 0) ? 0 : static_cast<std::uint8_t>(64 + (count * 191) / 255);
+    }
+}
+
+constexpr std::size_t CoverageMap::Size;
+constexpr std::uint32_t CoverageMap::HeatmapSize;
+
+CoverageMap::CoverageMap()
+{
+    clear();
+}
+
+//public
+void CoverageMap::clear()
+{
+    m_executed.reset();
+    m_reads.fill(0);
+    m_writes.fill(0);
+}
+
+CoverageMap::Summary CoverageMap::getSummary(std::uint16_t start, std::uint32_t size) const
+{
+    Summary summary;
+    for (auto i = 0u; i < size && start + i < Size; ++i)
+    {
+        const auto address = start + i;
+        if (m_executed[address]) summary.executed++;
+        if (m_reads[address]) summary.read++;
+        if (m_writes[address]) summary.written++;
+    }
+    return summary;
+}
+
+void CoverageMap::getHeatmap(std::vector<std::uint8_t>& dst) const
+{
+    dst.resize(Size * 4);
+    for (auto i = 0u; i < Size; ++i)
+    {
+        auto* pixel = &dst[i * 4];
+        pixel[0] = getIntensity(m_writes[i]);
+        pixel[1] = getIntensity(m_reads[i]);
+        pixel[2] = m_executed[i] ? 255 : 0;
+        pixel[3] = 255;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <I8080/Crc32.hpp>
+
+#include <array>
+
+namespace
+{
+    std::array<std::uint32_t, 256> createTable()
+    {
+        std::array<std::uint32_t, 256> table = {};
+        for (auto i = 0u; i < table.size(); ++i)
+        {
+            auto value = i;
+            for (auto j = 0; j < 8; ++j)
+            {
+                value = (value & 1) ? (0xEDB88320 ^ (value >> 1)) : (value >> 1);
+            }
+            table[i] = value;
+        }
+        return table;
+    }
+}
+
+std::uint32_t I8080::crc32(const void* data, std::size_t size, std::uint32_t crc)
+{
+    static const auto table = createTable();
+
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    crc = ~crc;
+    for (auto i = 0u; i < size; ++i)
+    {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
\ No newline at end of file
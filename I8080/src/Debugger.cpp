@@ -0,0 +1,261 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <I8080/Debugger.hpp>
+
+#include <cstdio>
+
+using namespace I8080;
+
+namespace
+{
+    bool matches(const Debugger::Watchpoint& watchpoint, std::uint8_t before, std::uint8_t after, bool write)
+    {
+        switch (watchpoint.condition)
+        {
+        default:
+        case Debugger::Condition::Any: return true;
+        case Debugger::Condition::Equal: return after == watchpoint.value;
+        case Debugger::Condition::NotEqual: return after != watchpoint.value;
+        case Debugger::Condition::Changed: return write && before != after;
+        }
+    }
+}
+
+constexpr std::size_t Debugger::HistorySize;
+
+Debugger::Debugger()
+    : m_breakpointCount (0),
+    m_step              (Step::None),
+    m_stepStarted       (false),
+    m_stepPC            (0),
+    m_stepSP            (0),
+    m_lastFlow          (Flow::None),
+    m_ignoreBreakpoint  (false),
+    m_programCounter    (0),
+    m_history           (),
+    m_historyIndex      (0)
+{
+
+}
+
+//public
+void Debugger::addBreakpoint(std::uint16_t address)
+{
+    if (!m_breakpoints[address])
+    {
+        m_breakpoints[address] = true;
+        m_breakpointCount++;
+    }
+}
+
+void Debugger::removeBreakpoint(std::uint16_t address)
+{
+    if (m_breakpoints[address])
+    {
+        m_breakpoints[address] = false;
+        m_breakpointCount--;
+    }
+}
+
+void Debugger::clearBreakpoints()
+{
+    m_breakpoints.reset();
+    m_breakpointCount = 0;
+}
+
+void Debugger::addWatchpoint(const Watchpoint& watchpoint)
+{
+    m_watchpoints.push_back(watchpoint);
+}
+
+void Debugger::clearWatchpoints()
+{
+    m_watchpoints.clear();
+}
+
+void Debugger::resume()
+{
+    run(Step::None);
+}
+
+void Debugger::breakNow()
+{
+    if (!isStopped())
+    {
+        m_step = Step::Break;
+    }
+}
+
+void Debugger::stepInto()
+{
+    run(Step::Into);
+}
+
+void Debugger::stepOver()
+{
+    run(Step::Over);
+}
+
+void Debugger::stepOut()
+{
+    run(Step::Out);
+}
+
+std::string Debugger::getStopDescription() const
+{
+    char str[64];
+    switch (m_stop.reason)
+    {
+    default:
+    case StopReason::None:
+        return "Running";
+    case StopReason::Breakpoint:
+        std::snprintf(str, sizeof(str), "Breakpoint at 0x%04X", m_stop.programCounter);
+        break;
+    case StopReason::Watchpoint:
+        std::snprintf(str, sizeof(str), "Watchpoint: 0x%04X %s 0x%02X by 0x%04X", m_stop.address,
+            m_stop.write ? "written" : "read", m_stop.value, m_stop.programCounter);
+        break;
+    case StopReason::Step:
+        std::snprintf(str, sizeof(str), "Stepped to 0x%04X", m_stop.programCounter);
+        break;
+    case StopReason::Break:
+        std::snprintf(str, sizeof(str), "Break at 0x%04X", m_stop.programCounter);
+        break;
+    }
+    return str;
+}
+
+std::uint16_t Debugger::getHistory(std::size_t idx) const
+{
+    return m_history[(m_historyIndex + HistorySize - 1 - (idx % HistorySize)) % HistorySize];
+}
+
+bool Debugger::canExecute(std::uint16_t programCounter, std::uint16_t stackPointer, std::uint8_t opcode)
+{
+    m_programCounter = programCounter;
+    if (isStopped()) return false;
+
+    if (m_step == Step::Break
+        || (m_breakpoints[programCounter] && !m_ignoreBreakpoint))
+    {
+        stop(m_step == Step::Break ? StopReason::Break : StopReason::Breakpoint);
+        return false;
+    }
+    m_ignoreBreakpoint = false;
+
+    //steps are set up from the first instruction they execute
+    if (m_step != Step::None && !m_stepStarted)
+    {
+        m_stepStarted = true;
+        m_stepSP = stackPointer;
+
+        const auto& info = opInfo[opcode];
+        if (m_step == Step::Over)
+        {
+            if (info.flow == Flow::Call || info.flow == Flow::CondCall || info.flow == Flow::Restart)
+            {
+                m_stepPC = programCounter + info.length;
+            }
+            else
+            {
+                m_step = Step::Into;
+            }
+        }
+    }
+    else if (m_step == Step::Over
+        && programCounter == m_stepPC && stackPointer == m_stepSP)
+    {
+        stop(StopReason::Step);
+        return false;
+    }
+
+    m_lastFlow = opInfo[opcode].flow;
+    m_history[m_historyIndex] = programCounter;
+    m_historyIndex = (m_historyIndex + 1) % HistorySize;
+
+    return true;
+}
+
+bool Debugger::executed(const MemoryAccess& access, const std::uint8_t* memory,
+    std::uint16_t programCounter, std::uint16_t stackPointer)
+{
+    if (access.size > 0 && !m_watchpoints.empty()
+        && checkWatchpoints(access, memory))
+    {
+        return false;
+    }
+
+    if (m_step == Step::Into
+        || (m_step == Step::Out && stackPointer > m_stepSP
+            && (m_lastFlow == Flow::Return || m_lastFlow == Flow::CondReturn)))
+    {
+        m_programCounter = programCounter;
+        stop(StopReason::Step);
+        return false;
+    }
+    return true;
+}
+
+//private
+void Debugger::stop(StopReason reason)
+{
+    m_stop = {};
+    m_stop.reason = reason;
+    m_stop.programCounter = m_programCounter;
+    m_step = Step::None;
+}
+
+void Debugger::run(Step step)
+{
+    m_stop = {};
+    m_step = step;
+    m_stepStarted = false;
+    m_ignoreBreakpoint = true;
+}
+
+bool Debugger::checkWatchpoints(const MemoryAccess& access, const std::uint8_t* memory)
+{
+    for (const auto& watchpoint : m_watchpoints)
+    {
+        for (auto i = 0u; i < access.size; ++i)
+        {
+            const std::uint16_t address = access.address + i;
+            if (static_cast<std::uint16_t>(address - watchpoint.address) >= watchpoint.length) continue;
+
+            const auto before = access.before[i];
+            const auto after = memory[address];
+            const bool write = (access.write && watchpoint.write && matches(watchpoint, before, after, true));
+            if (write || (access.read && watchpoint.read && matches(watchpoint, before, before, false)))
+            {
+                stop(StopReason::Watchpoint);
+                m_stop.address = address;
+                m_stop.value = write ? after : before;
+                m_stop.write = write;
+                return true;
+            }
+        }
+    }
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,226 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <I8080/Disassembler.hpp>
+#include <I8080/OpInfo.hpp>
+#include <I8080/Crc32.hpp>
+
+#include <cstdio>
+
+using namespace I8080;
+
+namespace
+{
+    const std::uint32_t endOfFlow = 0x10000;
+}
+
+Disassembler::Disassembler()
+    : m_memory  (nullptr),
+    m_checksum  (0)
+{
+
+}
+
+//public
+void Disassembler::setMemory(const std::uint8_t* memory, const std::vector<Range>& roms)
+{
+    m_memory = memory;
+    m_roms = roms;
+
+    m_checksum = 0;
+    for (const auto& rom : m_roms)
+    {
+        const std::uint8_t start[] = { static_cast<std::uint8_t>(rom.start & 0xFF), static_cast<std::uint8_t>(rom.start >> 8) };
+        m_checksum = crc32(start, sizeof(start), m_checksum);
+        m_checksum = crc32(memory + rom.start, rom.size, m_checksum);
+    }
+
+    if (m_roms.empty())
+    {
+        m_analysis.reset();
+        return;
+    }
+
+    auto& analysis = cache()[m_checksum];
+    if (!analysis)
+    {
+        analysis = std::make_shared<Analysis>();
+        analysis->pending.push_back(0);
+    }
+    m_analysis = analysis;
+}
+
+void Disassembler::clearCache()
+{
+    cache().clear();
+}
+
+void Disassembler::addEntryPoint(std::uint16_t address)
+{
+    if (m_analysis && !m_analysis->code[address])
+    {
+        m_analysis->pending.push_back(address);
+    }
+}
+
+bool Disassembler::isCode(std::uint16_t address)
+{
+    analyse();
+    return m_analysis && m_analysis->code[address];
+}
+
+std::size_t Disassembler::getCodeSize()
+{
+    analyse();
+    return m_analysis ? m_analysis->covered.count() : 0;
+}
+
+std::string Disassembler::getLine(std::uint16_t address, std::uint16_t& length)
+{
+    char line[48];
+    if (!m_memory || !isROM(address))
+    {
+        length = 1;
+        std::snprintf(line, sizeof(line), "%04X", address);
+        return line;
+    }
+
+    if (!isCode(address))
+    {
+        length = 1;
+        std::snprintf(line, sizeof(line), "%04X  %02X          DB $%02X", address, m_memory[address], m_memory[address]);
+        return line;
+    }
+
+    const auto& info = opInfo[m_memory[address]];
+    length = info.length;
+
+    //operand placeholders in the mnemonic are replaced with their values
+    std::string mnemonic(info.mnemonic);
+    char bytes[12] = {};
+    char operand[8] = {};
+    switch (info.length)
+    {
+    default:
+    case 1:
+        std::snprintf(bytes, sizeof(bytes), "%02X", m_memory[address]);
+        break;
+    case 2:
+        std::snprintf(bytes, sizeof(bytes), "%02X %02X", m_memory[address], m_memory[address + 1]);
+        std::snprintf(operand, sizeof(operand), "$%02X", m_memory[address + 1]);
+        mnemonic.replace(mnemonic.find("d8"), 2, operand);
+        break;
+    case 3:
+        std::snprintf(bytes, sizeof(bytes), "%02X %02X %02X", m_memory[address], m_memory[address + 1], m_memory[address + 2]);
+        std::snprintf(operand, sizeof(operand), "$%02X%02X", m_memory[address + 2], m_memory[address + 1]);
+        mnemonic.replace(mnemonic.find("16") - 1, 3, operand);
+        break;
+    }
+
+    std::snprintf(line, sizeof(line), "%04X  %-10s  %s", address, bytes, mnemonic.c_str());
+    return line;
+}
+
+std::string Disassembler::getListing(std::uint16_t address, std::size_t count)
+{
+    std::string listing;
+    for (auto i = 0u; i < count; ++i)
+    {
+        std::uint16_t length = 0;
+        listing += getLine(address, length) + "\n";
+        address += length;
+    }
+    return listing;
+}
+
+//private
+Disassembler::Cache& Disassembler::cache()
+{
+    static Cache results;
+    return results;
+}
+
+bool Disassembler::isROM(std::uint32_t address) const
+{
+    for (const auto& rom : m_roms)
+    {
+        if (address >= rom.start && address < rom.start + rom.size)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Disassembler::analyse()
+{
+    if (!m_analysis || !m_memory) return;
+
+    auto& analysis = *m_analysis;
+    while (!analysis.pending.empty())
+    {
+        std::uint32_t address = analysis.pending.back();
+        analysis.pending.pop_back();
+
+        //follow the flow until it ends or meets code already found,
+        //queuing the other side of any branches
+        while (isROM(address) && !analysis.code[address])
+        {
+            const auto opcode = m_memory[address];
+            const auto& info = opInfo[opcode];
+            if (!isROM(address + info.length - 1)) break;
+
+            analysis.code[address] = true;
+            for (auto i = 0u; i < info.length; ++i)
+            {
+                analysis.covered[address + i] = true;
+            }
+
+            const std::uint16_t target = (info.length == 3) ? (m_memory[address + 1] | (m_memory[address + 2] << 8)) : 0;
+            const auto next = address + info.length;
+            switch (info.flow)
+            {
+            default:
+                address = next;
+                break;
+            case Flow::Jump:
+                //PCHL jumps to an address only known at run time
+                address = (info.length == 3) ? target : endOfFlow;
+                break;
+            case Flow::CondJump:
+            case Flow::Call:
+            case Flow::CondCall:
+                analysis.pending.push_back(target);
+                address = next;
+                break;
+            case Flow::Restart:
+                analysis.pending.push_back(opcode & 0x38);
+                address = next;
+                break;
+            case Flow::Return:
+                address = endOfFlow;
+                break;
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,219 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <I8080/I8080.hpp>
+#include <I8080/OpInfo.hpp>
+#include <I8080/Crc32.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+using namespace I8080;
+
+namespace
+{
+    const Byte JNZ = 0xC2;
+    const Word RowStride = 0x20; //bytes per column of the rotated screen
+}
+
+//private
+void CPU::installHooks(Word start, std::uint32_t size)
+{
+    //guest loops replaced by native routines. Each is keyed by the
+    //checksum of the ROM chip it's in, and the bytes of the loop itself
+    //are checked too. Every loop ends with DCR B, JNZ back to its head
+    struct KnownRoutine final
+    {
+        std::uint32_t chipChecksum;
+        Word address;
+        std::vector<Byte> signature;
+        HookRoutine routine;
+    };
+
+    static const std::vector<KnownRoutine> knownRoutines =
+    {
+        //invaders.f
+        { 0x0CCEAD96, 0x1405,
+        { 0xC5, 0xE5, 0x1A, 0xD3, 0x04, 0xDB, 0x03, 0xB6, 0x77, 0x23, 0x13, 0xAF, 0xD3, 0x04, 0xDB, 0x03,
+        0xB6, 0x77, 0xE1, 0x01, 0x20, 0x00, 0x09, 0xC1, 0x05, 0xC2, 0x05, 0x14 },
+        &CPU::drawShiftedSprite },
+        { 0x0CCEAD96, 0x1427,
+        { 0xC5, 0xE5, 0xAF, 0x77, 0x23, 0x77, 0x23, 0xE1, 0x01, 0x20, 0x00, 0x09, 0xC1, 0x05, 0xC2, 0x27, 0x14 },
+        &CPU::eraseSimpleSprite },
+        { 0x0CCEAD96, 0x1439,
+        { 0xC5, 0x1A, 0x77, 0x13, 0x01, 0x20, 0x00, 0x09, 0xC1, 0x05, 0xC2, 0x39, 0x14 },
+        &CPU::drawSimpleSprite },
+
+        //invaders.e
+        { 0x14E538B0, 0x1A32,
+        { 0x1A, 0x77, 0x23, 0x13, 0x05, 0xC2, 0x32, 0x1A },
+        &CPU::blockCopy }
+    };
+
+    const auto checksum = crc32(&m_memory[start], size);
+    for (const auto& known : knownRoutines)
+    {
+        const auto end = known.address + known.signature.size();
+        if (known.chipChecksum != checksum
+            || known.address < start || end > start + size
+            || !std::equal(known.signature.begin(), known.signature.end(), m_memory.begin() + known.address))
+        {
+            continue;
+        }
+
+        Hook hook;
+        hook.address = known.address;
+        hook.exit = static_cast<Word>(end);
+        hook.routine = known.routine;
+        for (auto i = 0u; i < known.signature.size(); i += opInfo[known.signature[i]].length)
+        {
+            hook.cycles += opCycles[known.signature[i]];
+            hook.instructions++;
+        }
+        assert(known.signature[known.signature.size() - 3] == JNZ);
+
+        m_hooks.push_back(hook);
+        m_hookAddresses[hook.address] = true;
+    }
+}
+
+void CPU::clearHooks()
+{
+    m_hooks.clear();
+    m_hookAddresses.reset();
+}
+
+bool CPU::runHook(Word address)
+{
+    for (const auto& hook : m_hooks)
+    {
+        if (hook.address != address) continue;
+
+        //only run whole iterations which leave cycles to spare so the
+        //update ends on the same instruction it would when interpreted
+        const std::uint32_t budget = (m_cycleCount - 1) / hook.cycles;
+        const std::uint32_t remaining = m_registers.B ? m_registers.B : 0x100;
+        const auto iterations = std::min(budget, remaining);
+        if (iterations == 0) return false;
+
+        ((*this).*(hook.routine))(iterations);
+
+        //the last DCR B is left to its opcode so the flags are exact.
+        //Opcodes used by routines move the PC, which is set here
+        m_registers.B++;
+        dcrb();
+
+        m_registers.programCounter = m_registers.B ? hook.address : hook.exit;
+        m_currentOpcode = JNZ;
+        m_cycleCount -= iterations * hook.cycles;
+        m_instructionCount += iterations * hook.instructions;
+        return true;
+    }
+    return false;
+}
+
+//LXI B,$0020 then DAD B
+void CPU::nextRow()
+{
+    m_registers.BC = RowStride;
+    dadb();
+}
+
+//DrawShiftedSprite, ORs each byte of the sprite on to the screen through
+//the shift register, along with the bits shifted out of it
+void CPU::drawShiftedSprite(std::uint32_t iterations)
+{
+    for (auto i = 0u; i < iterations; ++i)
+    {
+        pushWord(m_registers.BC);
+        pushWord(m_registers.HL);
+
+        m_registers.A = m_memory[m_registers.DE];
+        handleOutput(4, m_registers.A);
+        m_registers.A = handleInput(3) | m_memory[m_registers.HL];
+        m_memory[m_registers.HL] = m_registers.A;
+        m_registers.HL++;
+        m_registers.DE++;
+
+        m_registers.A = 0;
+        handleOutput(4, m_registers.A);
+        m_registers.A = handleInput(3) | m_memory[m_registers.HL];
+        m_memory[m_registers.HL] = m_registers.A;
+
+        m_registers.HL = popWord();
+        nextRow();
+        m_registers.BC = popWord();
+        m_registers.B--;
+    }
+}
+
+//EraseSimpleSprite, clears two bytes of each row
+void CPU::eraseSimpleSprite(std::uint32_t iterations)
+{
+    for (auto i = 0u; i < iterations; ++i)
+    {
+        pushWord(m_registers.BC);
+        pushWord(m_registers.HL);
+
+        m_registers.A = 0;
+        m_memory[m_registers.HL] = m_registers.A;
+        m_registers.HL++;
+        m_memory[m_registers.HL] = m_registers.A;
+        m_registers.HL++;
+
+        m_registers.HL = popWord();
+        nextRow();
+        m_registers.BC = popWord();
+        m_registers.B--;
+    }
+}
+
+//DrawSimpSprite, copies the sprite a byte per row without shifting
+void CPU::drawSimpleSprite(std::uint32_t iterations)
+{
+    for (auto i = 0u; i < iterations; ++i)
+    {
+        pushWord(m_registers.BC);
+
+        m_registers.A = m_memory[m_registers.DE];
+        m_memory[m_registers.HL] = m_registers.A;
+        m_registers.DE++;
+
+        nextRow();
+        m_registers.BC = popWord();
+        m_registers.B--;
+    }
+}
+
+//BlockCopy, copies B bytes from DE to HL
+void CPU::blockCopy(std::uint32_t iterations)
+{
+    for (auto i = 0u; i < iterations; ++i)
+    {
+        m_registers.A = m_memory[m_registers.DE];
+        m_memory[m_registers.HL] = m_registers.A;
+        m_registers.HL++;
+        m_registers.DE++;
+        m_registers.B--;
+    }
+}
\ No newline at end of file
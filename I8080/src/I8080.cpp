@@ -22,11 +22,15 @@ source distribution.
 *********************************************************************/
 
 #include <I8080/I8080.hpp>
+#include <I8080/OpInfo.hpp>
 
+#include <algorithm>
+#include <cstdio>
 #include <cstring>
 #include <cassert>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 
 //this hides some of the horrors of using pointer to member functions
@@ -36,31 +40,11 @@ using namespace I8080;
 
 namespace
 {
-    //maps number of I8080 cycles take by each opcode
-    //these seem to vary depending on hardware info source...
-    const std::array<Byte, 256> opCycles = 
-    {
-        4,  10, 7,  5,  5,  5,  7,  4,  4 , 10, 7,  5,  5,  5,  7,  4,
-        4,  10, 7,  5,  5,  5,  7,  4,  4,  10, 7,  5,  5,  5,  7,  4, 
-        4,  10, 16, 5,  5,  5,  7,  4,  4,  10, 16, 5,  5,  5,  7,  4,
-        4,  10, 13, 5,  10, 10, 10, 4,  4,  10, 13, 5,  5,  5,  7,  4,
-        5,  5,  5,  5,  5,  5,  7,  5,  5,  5,  5,  5,  5,  5,  7,  5,
-        5,  5,  5,  5,  5,  5,  7,  5,  5,  5,  5,  5,  5,  5,  7,  5,
-        5,  5,  5,  5,  5,  5,  7,  5,  5,  5,  5,  5,  5,  5,  7,  5,
-        7,  7,  7,  7,  7,  7,  7,  7,  5,  5,  5,  5,  5,  5,  7,  5,
-        4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
-        4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
-        4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
-        4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
-        11, 10, 10, 10, 17, 11, 7,  11, 11, 10, 10, 10, 10, 17, 7,  11,
-        11, 10, 10, 10, 17, 11, 7,  11, 11, 10, 10, 10, 10, 17, 7,  11,
-        11, 10, 10, 18, 17, 11, 7,  11, 11, 5,  10, 5,  17, 17, 7,  11,
-        11, 10, 10, 4,  17, 11, 7,  11, 11, 5,  10, 4,  17, 17, 7,  11
-    };
-
     const Word VRAM_OFFSET = 0x2400;
 }
 
+constexpr std::uint32_t CPU::FeatureBits;
+
 CPU::Registers::Registers()
     : A(m_a), B(m_bc.b.h), C(m_bc.b.l), D(m_de.b.h), E(m_de.b.l), H(m_hl.b.h), L(m_hl.b.l),
     M(m_hl.w), BC(m_bc.w), DE(m_de.w), HL(m_hl.w), programCounter(m_programCounter.w), stackPointer(m_stackPointer.w),
@@ -74,10 +58,19 @@ CPU::Registers::Registers()
 }
 
 CPU::CPU()
-    : m_cycleCount      (0),
-    m_currentOpcode     (0),
-    m_interruptEnabled  (false),
-    m_interruptPending  (0)
+    : m_cycleCount       (0),
+    m_sliceCycles        (0),
+    m_totalCycles        (0),
+    m_instructionCount   (0),
+    m_features           (0),
+    m_sequence           (0),
+    m_sequenceLength     (0),
+    m_sequenceAddress    (0),
+    m_romsChanged        (false),
+    m_interruptVectors   (0),
+    m_currentOpcode      (0),
+    m_interruptEnabled   (false),
+    m_interruptPending   (0)
 {
     m_registers.BC = 0;
     m_registers.DE = 0;
@@ -111,6 +104,40 @@ CPU::CPU()
         &CPU::cp,      &CPU::poppsw,  &CPU::jp,      &CPU::di,      &CPU::cp,      &CPU::pushpsw, &CPU::ori,     &CPU::rst6,    &CPU::rm,      &CPU::sphl,    &CPU::jm,      &CPU::ei,      &CPU::cm,      &CPU::notImpl, &CPU::cpi,     &CPU::rst7
     };
 
+    //chosen from writeSequenceStats() over the inner loops of the sprite
+    //and copy routines which dominate frame time, taking the runs with the
+    //most cycles which don't overlap within those loops
+    auto fuse = [this](std::initializer_list<Byte> opcodes, Opcode handler)
+    {
+        auto& candidates = m_fusedSequences[*opcodes.begin()];
+        auto sequence = std::find_if(candidates.begin(), candidates.end(),
+            [](const FusedSequence& candidate) { return candidate.handler == nullptr; });
+        assert(sequence != candidates.end() && opcodes.size() > 1 && opcodes.size() <= 3);
+
+        sequence->handler = handler;
+        auto opcode = opcodes.begin();
+        Byte offset = 0;
+        for (; opcode + 1 != opcodes.end(); ++opcode)
+        {
+            offset += opInfo[*opcode].length;
+            sequence->cycles += opCycles[*opcode];
+            sequence->following[sequence->count] = *(opcode + 1);
+            sequence->offsets[sequence->count] = offset;
+            sequence->count++;
+        }
+    };
+    fuse({ 0x01, 0x09, 0xC1 }, &CPU::lxibDadbPopb);
+    fuse({ 0xD3, 0xDB, 0xB6 }, &CPU::outInOram);
+    fuse({ 0x77, 0x23, 0x13 }, &CPU::movmaInxhInxd);
+    fuse({ 0x77, 0x23 }, &CPU::movmaInxh);
+    fuse({ 0x05, 0xC2 }, &CPU::dcrbJnz);
+    fuse({ 0xC5, 0xE5 }, &CPU::pushbPushh);
+    fuse({ 0x1A, 0x77 }, &CPU::ldaxdMovma);
+    fuse({ 0x23, 0x13 }, &CPU::inxhInxd);
+
+    m_executor = &CPU::execute<0>;
+    m_debugExecutor = &CPU::execute<Debugging>;
+
 #ifdef OP_TEST
     runTests();
     reset();
@@ -122,6 +149,9 @@ CPU::CPU()
 void CPU::reset()
 {   
     m_cycleCount = 0;
+    m_sliceCycles = 0;
+    m_totalCycles = 0;
+    m_instructionCount = 0;
     m_currentOpcode = 0;
     m_interruptEnabled = false;
     m_interruptPending = 0;
@@ -138,36 +168,28 @@ void CPU::reset()
     std::memset(m_memory.data(), 0, MEM_SIZE);
     m_memory[0x1FFF] = 0xC3; //jumps to zero in inf loop by default
 
-#ifdef DEBUG_TOOLS
-    m_disassembly.clear();
-#endif //DEBUG_TOOLS
-}
+    m_callProfiler.unwind();
 
-namespace
-{
-    std::uint32_t totalCycles = 0;
+    m_romRanges.clear();
+    m_romsChanged = true;
+    m_interruptVectors = 0;
+    clearHooks();
 }
 
 std::int32_t CPU::update(std::int32_t count)
 {
     //assert(count > 0);
 
+    //fold in the previous update, along with anything
+    //charged since such as interrupt service cycles
+    m_totalCycles += (m_sliceCycles - m_cycleCount);
+
     //fetch the opcode from memory
     //then execute it and update the number of CPU
     //cycles taken for that opcode
+    m_sliceCycles = count;
     m_cycleCount = count;
-    while (m_cycleCount > 0)
-    {
-        m_currentOpcode = m_memory[m_registers.programCounter];
-        EXEC_OPCODE(m_currentOpcode);
-        m_cycleCount -= opCycles[m_currentOpcode];
-
-#ifdef  DEBUG_TOOLS
-        m_callstack.push(m_registers.programCounter);
-#endif //DEBUG_TOOLS
-
-    }
-    totalCycles += -m_cycleCount;
+    ((*this).*(m_debugger.isActive() ? m_debugExecutor : m_executor))();
 
     return count - m_cycleCount;
 }
@@ -181,6 +203,20 @@ void CPU::raiseInterrupt(Byte id)
     {
         m_interruptEnabled = false;
         m_interruptPending = 0;
+        m_interruptVectors |= (1 << id);
+        if (m_features & CallProfiling)
+        {
+            m_callProfiler.enter(id * ISR_Size, m_registers.stackPointer, true);
+            m_callProfiler.addCycles(ISR_Cycles);
+        }
+        if (m_features & Coverage)
+        {
+            MemoryAccess access;
+            access.address = m_registers.stackPointer - 2;
+            access.size = 2;
+            access.write = true;
+            m_coverage.addAccess(access);
+        }
         //push the current working position on to the stack
         pushWord(m_registers.programCounter);
         //jump the program counter to the ISR address
@@ -195,29 +231,183 @@ void CPU::raiseInterrupt(Byte id)
 
 bool CPU::loadROM(const std::string& path, Word address, bool rst)
 {
-    if (rst) reset(); //ROMs might be multiple parts
-
     std::ifstream file(path, std::ios::in | std::ios::binary);
     if (file.fail() || !file.good())
     {
         file.close();
+        if (rst) reset();
         std::cout << "Failed opening file " << path << std::endl;
         return false;
     }
 
-    file.seekg(0, file.end);
-    auto size = file.tellg();
-    file.seekg(0, file.beg);
+    const std::vector<Byte> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!loadROM(data, address, rst))
+    {
+        std::cout << "Invalid file size... " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool CPU::loadROM(const std::vector<Byte>& data, Word address, bool rst)
+{
+    if (rst) reset(); //ROMs might be multiple parts
 
-    if (size > 0 && size < (m_memory.size() - address)) //TODO this doesn't account for stack space...
+    if (!data.empty() && data.size() <= (m_memory.size() - address)) //TODO this doesn't account for stack space...
     {
-        file.read((char*)&m_memory[address], size);
+        std::memcpy(&m_memory[address], data.data(), data.size());
+
+        Disassembler::Range range;
+        range.start = address;
+        range.size = static_cast<std::uint32_t>(data.size());
+        m_romRanges.push_back(range);
+        m_romsChanged = true;
+
+        installHooks(address, range.size);
         return true;
     }
-    std::cout << "Invalid file size... " << path << std::endl;
     return false;
 }
 
+void CPU::saveState(State& state) const
+{
+    state.a = m_registers.A;
+    state.flags = *(const Byte*)(&m_flags);
+    state.bc = m_registers.BC;
+    state.de = m_registers.DE;
+    state.hl = m_registers.HL;
+    state.programCounter = m_registers.programCounter;
+    state.stackPointer = m_registers.stackPointer;
+
+    state.cycleCount = m_cycleCount;
+    state.sliceCycles = m_sliceCycles;
+    state.totalCycles = m_totalCycles;
+    state.instructionCount = m_instructionCount;
+
+    state.currentOpcode = m_currentOpcode;
+    state.interruptEnabled = m_interruptEnabled;
+    state.interruptPending = m_interruptPending;
+
+    std::memcpy(state.memory.data(), m_memory.data(), MEM_SIZE);
+}
+
+void CPU::loadState(const State& state)
+{
+    m_registers.A = state.a;
+    *(Byte*)(&m_flags) = state.flags;
+    m_registers.BC = state.bc;
+    m_registers.DE = state.de;
+    m_registers.HL = state.hl;
+    m_registers.programCounter = state.programCounter;
+    m_registers.stackPointer = state.stackPointer;
+
+    m_cycleCount = state.cycleCount;
+    m_sliceCycles = state.sliceCycles;
+    m_totalCycles = state.totalCycles;
+    m_instructionCount = state.instructionCount;
+
+    m_currentOpcode = state.currentOpcode;
+    m_interruptEnabled = state.interruptEnabled;
+    m_interruptPending = state.interruptPending;
+
+    std::memcpy(m_memory.data(), state.memory.data(), MEM_SIZE);
+}
+
+void CPU::setFeatures(std::uint32_t features)
+{
+    static const auto executors = makeExecutors(std::make_index_sequence<1u << FeatureBits>());
+
+    m_features = features & ((1u << FeatureBits) - 1) & ~Debugging;
+    m_executor = executors[m_features];
+    m_debugExecutor = executors[m_features | Debugging];
+}
+
+void CPU::resetOpcodeStats()
+{
+    m_opcodeStats.fill({});
+    m_sequenceCounts.clear();
+    m_sequenceLength = 0;
+}
+
+bool CPU::writeOpcodeStats(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file.good()) return false;
+
+    std::uint64_t totalCycles = 0;
+    for (const auto& stats : m_opcodeStats)
+    {
+        totalCycles += stats.cycles;
+    }
+
+    file << "opcode,mnemonic,executions,cycles,cycle_percent,taken,not_taken\n";
+    for (auto i = 0u; i < m_opcodeStats.size(); ++i)
+    {
+        const auto& stats = m_opcodeStats[i];
+        if (stats.executions == 0) continue;
+
+        const auto percent = (totalCycles > 0) ? (100.0 * stats.cycles) / totalCycles : 0.0;
+        file << "0x" << std::hex << i << std::dec << "," << opInfo[i].mnemonic << ","
+            << stats.executions << "," << stats.cycles << "," << percent << ","
+            << stats.taken << "," << stats.notTaken << "\n";
+    }
+    return file.good();
+}
+
+bool CPU::writeSequenceStats(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file.good()) return false;
+
+    //the length is stored above the opcodes in the key
+    std::vector<std::pair<std::uint32_t, std::uint64_t>> sequences;
+    for (const auto& count : m_sequenceCounts)
+    {
+        const auto length = count.first >> 24;
+        std::uint64_t cycles = 0;
+        for (auto i = 0u; i < length; ++i)
+        {
+            cycles += opCycles[(count.first >> (8 * i)) & 0xFF];
+        }
+        sequences.emplace_back(count.first, cycles * count.second);
+    }
+    std::sort(sequences.begin(), sequences.end(),
+        [](const std::pair<std::uint32_t, std::uint64_t>& a, const std::pair<std::uint32_t, std::uint64_t>& b)
+    {
+        return a.second > b.second;
+    });
+
+    //the percentage is of every cycle executed, so pairs and triples
+    //can be weighed against each other when choosing what to fuse
+    std::uint64_t totalCycles = 0;
+    for (const auto& stats : m_opcodeStats)
+    {
+        totalCycles += stats.cycles;
+    }
+
+    file << "opcodes,mnemonics,executions,cycles,cycle_percent\n";
+    for (const auto& sequence : sequences)
+    {
+        const auto length = sequence.first >> 24;
+        std::string opcodes;
+        std::string mnemonics;
+        for (auto i = length; i > 0; --i)
+        {
+            const auto opcode = (sequence.first >> (8 * (i - 1))) & 0xFF;
+            char hex[4];
+            std::snprintf(hex, sizeof(hex), "%02X", opcode);
+            opcodes += hex;
+            mnemonics += opInfo[opcode].mnemonic;
+            if (i > 1) mnemonics += "; ";
+        }
+
+        const auto percent = (totalCycles > 0) ? (100.0 * sequence.second) / totalCycles : 0.0;
+        file << "0x" << opcodes << ",\"" << mnemonics << "\"," << m_sequenceCounts.at(sequence.first) << ","
+            << sequence.second << "," << percent << "\n";
+    }
+    return file.good();
+}
+
 std::string CPU::getInfo() const
 {
     std::stringstream ss;
@@ -228,7 +418,7 @@ std::string CPU::getInfo() const
     ss << "PC: " << m_registers.programCounter << std::endl;
     ss << "SP: " << m_registers.stackPointer << std::endl;
     ss << "OP: " << (int)m_currentOpcode << std::endl;
-    ss << "Cycles: " << std::dec << totalCycles << std::endl;
+    ss << "Cycles: " << std::dec << getCycleCount() << std::endl;
     ss << "Flags: ";
     (m_flags.ac) ? ss << "AC," : ss << ".";
     (m_flags.cy) ? ss << "CY," : ss << ".";
@@ -240,12 +430,317 @@ std::string CPU::getInfo() const
     return ss.str();
 }
 
+std::uint64_t CPU::getCycleCount() const
+{
+    return m_totalCycles + (m_sliceCycles - m_cycleCount);
+}
+
 const Byte* CPU::getVRAM() const
 {
     return &m_memory[VRAM_OFFSET];
 }
 
+Disassembler& CPU::getDisassembler()
+{
+    if (m_romsChanged)
+    {
+        m_disassembler.setMemory(m_memory.data(), m_romRanges);
+        m_romsChanged = false;
+    }
+
+    static const int ISR_Size = 8;
+    for (auto i = 0; i < 8; ++i)
+    {
+        if (m_interruptVectors & (1 << i))
+        {
+            m_disassembler.addEntryPoint(i * ISR_Size);
+        }
+    }
+    return m_disassembler;
+}
+
 //private
+void CPU::writeTraceRecord()
+{
+    TraceRecord record;
+    record.cycle = getCycleCount();
+    record.programCounter = m_registers.programCounter;
+    record.stackPointer = m_registers.stackPointer;
+    record.bc = m_registers.BC;
+    record.de = m_registers.DE;
+    record.hl = m_registers.HL;
+    record.a = m_registers.A;
+    record.flags = *(const Byte*)(&m_flags);
+    record.opcode = m_currentOpcode;
+    m_traceWriter.write(record);
+}
+
+CPU::Opcode CPU::findFusedSequence(Word programCounter) const
+{
+    //a run is only fused if its last instruction
+    //would run in this update anyway
+    for (const auto& sequence : m_fusedSequences[m_currentOpcode])
+    {
+        if (!sequence.handler) break;
+
+        if (m_cycleCount > sequence.cycles
+            && m_memory[static_cast<Word>(programCounter + sequence.offsets[0])] == sequence.following[0]
+            && (sequence.count < 2 || m_memory[static_cast<Word>(programCounter + sequence.offsets[1])] == sequence.following[1]))
+        {
+            return sequence.handler;
+        }
+    }
+    return nullptr;
+}
+
+template <std::size_t... Modes>
+std::array<CPU::Executor, sizeof...(Modes)> CPU::makeExecutors(std::index_sequence<Modes...>)
+{
+    //a table of every instantiation of the loop, indexed by feature mask
+    return {{ &CPU::execute<Modes>... }};
+}
+
+template <std::uint32_t Mode>
+void CPU::execute()
+{
+    //hooks and fused runs skip instructions, so are disabled
+    //when any instrumentation needs to see each one
+    const bool instrumented = (Mode & (Profiling | CallProfiling | Debugging | InstructionTracing | Coverage)) != 0;
+    const bool hooks = (Mode & HighLevel) && !instrumented;
+    const bool fusion = (Mode & Fusion) && !instrumented;
+
+    //fetch the opcode from memory
+    //then execute it and update the number of CPU
+    //cycles taken for that opcode
+    while (m_cycleCount > 0)
+    {
+        const Word programCounter = m_registers.programCounter;
+        const Word stackPointer = m_registers.stackPointer;
+        (void)programCounter;
+        (void)stackPointer;
+
+        //hooks replace whole guest loops
+        if (hooks && m_hookAddresses[programCounter] && runHook(programCounter))
+        {
+            continue;
+        }
+
+        m_currentOpcode = m_memory[programCounter];
+
+        if ((Mode & Debugging)
+            && !m_debugger.canExecute(programCounter, stackPointer, m_currentOpcode))
+        {
+            break;
+        }
+
+        MemoryAccess access;
+        if (Mode & (Debugging | Coverage))
+        {
+            access = getMemoryAccess();
+        }
+
+        if (Mode & InstructionTracing)
+        {
+            writeTraceRecord();
+        }
+
+        //the handler of a fused run retires all but the last instruction
+        const auto fused = (fusion) ? findFusedSequence(programCounter) : nullptr;
+        if (fused)
+        {
+            ((*this).*(fused))();
+        }
+        else
+        {
+            EXEC_OPCODE(m_currentOpcode);
+        }
+        m_cycleCount -= opCycles[m_currentOpcode];
+        m_instructionCount++;
+
+        //Mode is a constant so disabled features are compiled out
+        if (Mode & Profiling)
+        {
+            updateOpcodeStats(programCounter, stackPointer);
+        }
+
+        if (Mode & CallProfiling)
+        {
+            updateCallProfiler(stackPointer);
+        }
+
+        if (Mode & (Debugging | Coverage))
+        {
+            //conditional calls and returns only touch the stack if taken
+            const auto stackAccess = opInfo[m_currentOpcode].access;
+            if ((stackAccess == Access::Push || stackAccess == Access::Pop)
+                && m_registers.stackPointer == stackPointer)
+            {
+                access.size = 0;
+            }
+        }
+
+        if (Mode & Coverage)
+        {
+            m_coverage.addInstruction(programCounter, opInfo[m_currentOpcode].length);
+            m_coverage.addAccess(access);
+        }
+
+        if ((Mode & Debugging)
+            && !m_debugger.executed(access, m_memory.data(), m_registers.programCounter, m_registers.stackPointer))
+        {
+            break;
+        }
+    }
+}
+
+void CPU::updateOpcodeStats(Word programCounter, Word stackPointer)
+{
+    auto& stats = m_opcodeStats[m_currentOpcode];
+    stats.executions++;
+    stats.cycles += opCycles[m_currentOpcode];
+    updateSequenceStats(programCounter);
+
+    //branches are judged by their effect, so this
+    //reflects what the handlers actually did
+    bool taken = false;
+    switch (opInfo[m_currentOpcode].flow)
+    {
+    default: return;
+    case Flow::CondJump:
+        taken = (m_registers.programCounter != programCounter + 3);
+        break;
+    case Flow::CondCall:
+    case Flow::CondReturn:
+        taken = (m_registers.stackPointer != stackPointer);
+        break;
+    }
+    (taken) ? stats.taken++ : stats.notTaken++;
+}
+
+void CPU::updateSequenceStats(Word programCounter)
+{
+    //a run is broken by anything which didn't continue from the
+    //end of the last instruction, such as a branch or an interrupt
+    if (programCounter != m_sequenceAddress)
+    {
+        m_sequenceLength = 0;
+    }
+    m_sequenceAddress = programCounter + opInfo[m_currentOpcode].length;
+    m_sequence = ((m_sequence << 8) | m_currentOpcode) & 0xFFFFFF;
+    m_sequenceLength = std::min(m_sequenceLength + 1, 3u);
+
+    if (m_sequenceLength > 1)
+    {
+        m_sequenceCounts[(2u << 24) | (m_sequence & 0xFFFF)]++;
+    }
+    if (m_sequenceLength > 2)
+    {
+        m_sequenceCounts[(3u << 24) | m_sequence]++;
+    }
+}
+
+void CPU::updateCallProfiler(Word stackPointer)
+{
+    //the cycles belong to the caller for a call, and
+    //to the routine being returned from for a return
+    m_callProfiler.addCycles(opCycles[m_currentOpcode]);
+    m_callProfiler.leave(m_registers.stackPointer);
+
+    switch (opInfo[m_currentOpcode].flow)
+    {
+    default: break;
+    case Flow::Call:
+    case Flow::CondCall:
+    case Flow::Restart:
+        //conditional calls only push if taken
+        if (m_registers.stackPointer == static_cast<Word>(stackPointer - 2))
+        {
+            m_callProfiler.enter(m_registers.programCounter, stackPointer, false);
+        }
+        break;
+    }
+}
+
+MemoryAccess CPU::getMemoryAccess() const
+{
+    MemoryAccess access;
+    switch (opInfo[m_currentOpcode].access)
+    {
+    default:
+    case Access::None:
+        return access;
+    case Access::ReadHL:
+        access.address = m_registers.HL;
+        access.size = 1;
+        access.read = true;
+        break;
+    case Access::WriteHL:
+        access.address = m_registers.HL;
+        access.size = 1;
+        access.write = true;
+        break;
+    case Access::ModifyHL:
+        access.address = m_registers.HL;
+        access.size = 1;
+        access.read = access.write = true;
+        break;
+    case Access::ReadBC:
+        access.address = m_registers.BC;
+        access.size = 1;
+        access.read = true;
+        break;
+    case Access::WriteBC:
+        access.address = m_registers.BC;
+        access.size = 1;
+        access.write = true;
+        break;
+    case Access::ReadDE:
+        access.address = m_registers.DE;
+        access.size = 1;
+        access.read = true;
+        break;
+    case Access::WriteDE:
+        access.address = m_registers.DE;
+        access.size = 1;
+        access.write = true;
+        break;
+    case Access::ReadDirect:
+    case Access::ReadDirectWord:
+        access.address = (m_memory[(m_registers.programCounter + 2) & 0xFFFF] << 8) | m_memory[(m_registers.programCounter + 1) & 0xFFFF];
+        access.size = (opInfo[m_currentOpcode].access == Access::ReadDirect) ? 1 : 2;
+        access.read = true;
+        break;
+    case Access::WriteDirect:
+    case Access::WriteDirectWord:
+        access.address = (m_memory[(m_registers.programCounter + 2) & 0xFFFF] << 8) | m_memory[(m_registers.programCounter + 1) & 0xFFFF];
+        access.size = (opInfo[m_currentOpcode].access == Access::WriteDirect) ? 1 : 2;
+        access.write = true;
+        break;
+    case Access::Push:
+        access.address = m_registers.stackPointer - 2;
+        access.size = 2;
+        access.write = true;
+        break;
+    case Access::Pop:
+        access.address = m_registers.stackPointer;
+        access.size = 2;
+        access.read = true;
+        break;
+    case Access::ExchangeStack:
+        access.address = m_registers.stackPointer;
+        access.size = 2;
+        access.read = access.write = true;
+        break;
+    }
+
+    //accesses at the top of memory wrap round to the bottom as on the bus
+    for (auto i = 0u; i < access.size; ++i)
+    {
+        access.before[i] = m_memory[(access.address + i) & 0xFFFF];
+    }
+    return access;
+}
+
 void CPU::pushWord(Word word)
 {
     m_registers.stackPointer -= 2;
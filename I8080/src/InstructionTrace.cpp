@@ -0,0 +1,195 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <I8080/InstructionTrace.hpp>
+
+#include <cstring>
+
+using namespace I8080;
+
+namespace
+{
+    const char magic[] = { 'I', '8', 'T', 'R', 1 };
+    const std::size_t bufferSize = 1024 * 1024;
+}
+
+constexpr std::size_t TraceWriter::MaxRecordSize;
+
+TraceWriter::TraceWriter()
+    : m_buffer  (bufferSize),
+    m_size      (0),
+    m_opcodeCycles()
+{
+
+}
+
+TraceWriter::~TraceWriter()
+{
+    close();
+}
+
+//public
+bool TraceWriter::open(const std::string& path)
+{
+    close();
+
+    m_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_file.good())
+    {
+        m_file.close();
+        return false;
+    }
+    m_file.write(magic, sizeof(magic));
+
+    m_size = 0;
+    m_last = {};
+    m_opcodeCycles.fill(0);
+    return true;
+}
+
+void TraceWriter::close()
+{
+    if (m_file.is_open())
+    {
+        flush();
+        m_file.close();
+    }
+}
+
+//private
+void TraceWriter::flush()
+{
+    if (m_file.is_open())
+    {
+        m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_size);
+    }
+    m_size = 0;
+}
+
+TraceReader::TraceReader()
+    : m_buffer  (bufferSize),
+    m_position  (0),
+    m_size      (0),
+    m_count     (0),
+    m_opcodeCycles()
+{
+
+}
+
+//public
+bool TraceReader::open(const std::string& path)
+{
+    m_file.close();
+    m_file.open(path, std::ios::in | std::ios::binary);
+
+    char header[sizeof(magic)];
+    if (!m_file.read(header, sizeof(header))
+        || std::memcmp(header, magic, sizeof(magic)) != 0)
+    {
+        m_file.close();
+        return false;
+    }
+
+    m_position = 0;
+    m_size = 0;
+    m_count = 0;
+    m_last = {};
+    m_opcodeCycles.fill(0);
+    return true;
+}
+
+bool TraceReader::next(TraceRecord& record)
+{
+    if (m_size - m_position < TraceWriter::MaxRecordSize && !fill()) return false;
+    if (m_size - m_position < 2) return false;
+
+    const auto* src = m_buffer.data() + m_position;
+    const auto* end = m_buffer.data() + m_size;
+    const auto mask = *src++;
+
+    //the opcode of the previous record decides the
+    //expected PC and cycle count of this one
+    const auto lastOpcode = m_last.opcode;
+    record = m_last;
+    record.programCounter = static_cast<std::uint16_t>(m_last.programCounter + opInfo[lastOpcode].length);
+    record.opcode = *src++;
+
+    auto readWord = [&src]()
+    {
+        std::uint16_t word = src[0] | (src[1] << 8);
+        src += 2;
+        return word;
+    };
+
+    //a truncated final record is ignored
+    static const std::array<std::uint8_t, 8> fieldSizes = { { 1, 1, 2, 2, 2, 2, 2, 1 } };
+    std::size_t size = 0;
+    for (auto i = 0u; i < fieldSizes.size(); ++i)
+    {
+        if (mask & (1 << i)) size += fieldSizes[i];
+    }
+    if (static_cast<std::size_t>(end - src) < size) return false;
+
+    if (mask & 0x01) record.a = *src++;
+    if (mask & 0x02) record.flags = *src++;
+    if (mask & 0x04) record.bc = readWord();
+    if (mask & 0x08) record.de = readWord();
+    if (mask & 0x10) record.hl = readWord();
+    if (mask & 0x20) record.stackPointer = readWord();
+    if (mask & 0x40) record.programCounter = readWord();
+    if (mask & 0x80)
+    {
+        std::uint64_t cycles = 0;
+        auto shift = 0u;
+        do
+        {
+            if (src == end || shift > 63) return false;
+            cycles |= static_cast<std::uint64_t>(*src & 0x7F) << shift;
+            shift += 7;
+        } while (*src++ & 0x80);
+        m_opcodeCycles[lastOpcode] = cycles;
+    }
+    record.cycle = m_last.cycle + m_opcodeCycles[lastOpcode];
+
+    m_position = src - m_buffer.data();
+    m_last = record;
+    m_count++;
+    return true;
+}
+
+//private
+bool TraceReader::fill()
+{
+    //move what's left to the front and top up the buffer
+    const auto remaining = m_size - m_position;
+    std::memmove(m_buffer.data(), m_buffer.data() + m_position, remaining);
+    m_position = 0;
+    m_size = remaining;
+
+    if (m_file.is_open())
+    {
+        m_file.read(reinterpret_cast<char*>(m_buffer.data() + m_size), m_buffer.size() - m_size);
+        m_size += static_cast<std::size_t>(m_file.gcount());
+    }
+    return m_size > 0;
+}
\ No newline at end of file
@@ -0,0 +1,307 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <I8080/OpInfo.hpp>
+
+using namespace I8080;
+
+const std::array<OpInfo, 256> I8080::opInfo =
+{
+    OpInfo{ "NOP", 1, Flow::None, Access::None }, //0x00
+    OpInfo{ "LXI B,d16", 3, Flow::None, Access::None },
+    OpInfo{ "STAX B", 1, Flow::None, Access::WriteBC },
+    OpInfo{ "INX B", 1, Flow::None, Access::None },
+    OpInfo{ "INR B", 1, Flow::None, Access::None },
+    OpInfo{ "DCR B", 1, Flow::None, Access::None },
+    OpInfo{ "MVI B,d8", 2, Flow::None, Access::None },
+    OpInfo{ "RLC", 1, Flow::None, Access::None },
+    OpInfo{ "*NOP", 1, Flow::None, Access::None },
+    OpInfo{ "DAD B", 1, Flow::None, Access::None },
+    OpInfo{ "LDAX B", 1, Flow::None, Access::ReadBC },
+    OpInfo{ "DCX B", 1, Flow::None, Access::None },
+    OpInfo{ "INR C", 1, Flow::None, Access::None },
+    OpInfo{ "DCR C", 1, Flow::None, Access::None },
+    OpInfo{ "MVI C,d8", 2, Flow::None, Access::None },
+    OpInfo{ "RRC", 1, Flow::None, Access::None },
+    OpInfo{ "*NOP", 1, Flow::None, Access::None }, //0x10
+    OpInfo{ "LXI D,d16", 3, Flow::None, Access::None },
+    OpInfo{ "STAX D", 1, Flow::None, Access::WriteDE },
+    OpInfo{ "INX D", 1, Flow::None, Access::None },
+    OpInfo{ "INR D", 1, Flow::None, Access::None },
+    OpInfo{ "DCR D", 1, Flow::None, Access::None },
+    OpInfo{ "MVI D,d8", 2, Flow::None, Access::None },
+    OpInfo{ "RAL", 1, Flow::None, Access::None },
+    OpInfo{ "*NOP", 1, Flow::None, Access::None },
+    OpInfo{ "DAD D", 1, Flow::None, Access::None },
+    OpInfo{ "LDAX D", 1, Flow::None, Access::ReadDE },
+    OpInfo{ "DCX D", 1, Flow::None, Access::None },
+    OpInfo{ "INR E", 1, Flow::None, Access::None },
+    OpInfo{ "DCR E", 1, Flow::None, Access::None },
+    OpInfo{ "MVI E,d8", 2, Flow::None, Access::None },
+    OpInfo{ "RAR", 1, Flow::None, Access::None },
+    OpInfo{ "*NOP", 1, Flow::None, Access::None }, //0x20
+    OpInfo{ "LXI H,d16", 3, Flow::None, Access::None },
+    OpInfo{ "SHLD a16", 3, Flow::None, Access::WriteDirectWord },
+    OpInfo{ "INX H", 1, Flow::None, Access::None },
+    OpInfo{ "INR H", 1, Flow::None, Access::None },
+    OpInfo{ "DCR H", 1, Flow::None, Access::None },
+    OpInfo{ "MVI H,d8", 2, Flow::None, Access::None },
+    OpInfo{ "DAA", 1, Flow::None, Access::None },
+    OpInfo{ "*NOP", 1, Flow::None, Access::None },
+    OpInfo{ "DAD H", 1, Flow::None, Access::None },
+    OpInfo{ "LHLD a16", 3, Flow::None, Access::ReadDirectWord },
+    OpInfo{ "DCX H", 1, Flow::None, Access::None },
+    OpInfo{ "INR L", 1, Flow::None, Access::None },
+    OpInfo{ "DCR L", 1, Flow::None, Access::None },
+    OpInfo{ "MVI L,d8", 2, Flow::None, Access::None },
+    OpInfo{ "CMA", 1, Flow::None, Access::None },
+    OpInfo{ "*NOP", 1, Flow::None, Access::None }, //0x30
+    OpInfo{ "LXI SP,d16", 3, Flow::None, Access::None },
+    OpInfo{ "STA a16", 3, Flow::None, Access::WriteDirect },
+    OpInfo{ "INX SP", 1, Flow::None, Access::None },
+    OpInfo{ "INR M", 1, Flow::None, Access::ModifyHL },
+    OpInfo{ "DCR M", 1, Flow::None, Access::ModifyHL },
+    OpInfo{ "MVI M,d8", 2, Flow::None, Access::WriteHL },
+    OpInfo{ "STC", 1, Flow::None, Access::None },
+    OpInfo{ "*NOP", 1, Flow::None, Access::None },
+    OpInfo{ "DAD SP", 1, Flow::None, Access::None },
+    OpInfo{ "LDA a16", 3, Flow::None, Access::ReadDirect },
+    OpInfo{ "DCX SP", 1, Flow::None, Access::None },
+    OpInfo{ "INR A", 1, Flow::None, Access::None },
+    OpInfo{ "DCR A", 1, Flow::None, Access::None },
+    OpInfo{ "MVI A,d8", 2, Flow::None, Access::None },
+    OpInfo{ "CMC", 1, Flow::None, Access::None },
+    OpInfo{ "MOV B,B", 1, Flow::None, Access::None }, //0x40
+    OpInfo{ "MOV B,C", 1, Flow::None, Access::None },
+    OpInfo{ "MOV B,D", 1, Flow::None, Access::None },
+    OpInfo{ "MOV B,E", 1, Flow::None, Access::None },
+    OpInfo{ "MOV B,H", 1, Flow::None, Access::None },
+    OpInfo{ "MOV B,L", 1, Flow::None, Access::None },
+    OpInfo{ "MOV B,M", 1, Flow::None, Access::ReadHL },
+    OpInfo{ "MOV B,A", 1, Flow::None, Access::None },
+    OpInfo{ "MOV C,B", 1, Flow::None, Access::None },
+    OpInfo{ "MOV C,C", 1, Flow::None, Access::None },
+    OpInfo{ "MOV C,D", 1, Flow::None, Access::None },
+    OpInfo{ "MOV C,E", 1, Flow::None, Access::None },
+    OpInfo{ "MOV C,H", 1, Flow::None, Access::None },
+    OpInfo{ "MOV C,L", 1, Flow::None, Access::None },
+    OpInfo{ "MOV C,M", 1, Flow::None, Access::ReadHL },
+    OpInfo{ "MOV C,A", 1, Flow::None, Access::None },
+    OpInfo{ "MOV D,B", 1, Flow::None, Access::None }, //0x50
+    OpInfo{ "MOV D,C", 1, Flow::None, Access::None },
+    OpInfo{ "MOV D,D", 1, Flow::None, Access::None },
+    OpInfo{ "MOV D,E", 1, Flow::None, Access::None },
+    OpInfo{ "MOV D,H", 1, Flow::None, Access::None },
+    OpInfo{ "MOV D,L", 1, Flow::None, Access::None },
+    OpInfo{ "MOV D,M", 1, Flow::None, Access::ReadHL },
+    OpInfo{ "MOV D,A", 1, Flow::None, Access::None },
+    OpInfo{ "MOV E,B", 1, Flow::None, Access::None },
+    OpInfo{ "MOV E,C", 1, Flow::None, Access::None },
+    OpInfo{ "MOV E,D", 1, Flow::None, Access::None },
+    OpInfo{ "MOV E,E", 1, Flow::None, Access::None },
+    OpInfo{ "MOV E,H", 1, Flow::None, Access::None },
+    OpInfo{ "MOV E,L", 1, Flow::None, Access::None },
+    OpInfo{ "MOV E,M", 1, Flow::None, Access::ReadHL },
+    OpInfo{ "MOV E,A", 1, Flow::None, Access::None },
+    OpInfo{ "MOV H,B", 1, Flow::None, Access::None }, //0x60
+    OpInfo{ "MOV H,C", 1, Flow::None, Access::None },
+    OpInfo{ "MOV H,D", 1, Flow::None, Access::None },
+    OpInfo{ "MOV H,E", 1, Flow::None, Access::None },
+    OpInfo{ "MOV H,H", 1, Flow::None, Access::None },
+    OpInfo{ "MOV H,L", 1, Flow::None, Access::None },
+    OpInfo{ "MOV H,M", 1, Flow::None, Access::ReadHL },
+    OpInfo{ "MOV H,A", 1, Flow::None, Access::None },
+    OpInfo{ "MOV L,B", 1, Flow::None, Access::None },
+    OpInfo{ "MOV L,C", 1, Flow::None, Access::None },
+    OpInfo{ "MOV L,D", 1, Flow::None, Access::None },
+    OpInfo{ "MOV L,E", 1, Flow::None, Access::None },
+    OpInfo{ "MOV L,H", 1, Flow::None, Access::None },
+    OpInfo{ "MOV L,L", 1, Flow::None, Access::None },
+    OpInfo{ "MOV L,M", 1, Flow::None, Access::ReadHL },
+    OpInfo{ "MOV L,A", 1, Flow::None, Access::None },
+    OpInfo{ "MOV M,B", 1, Flow::None, Access::WriteHL }, //0x70
+    OpInfo{ "MOV M,C", 1, Flow::None, Access::WriteHL },
+    OpInfo{ "MOV M,D", 1, Flow::None, Access::WriteHL },
+    OpInfo{ "MOV M,E", 1, Flow::None, Access::WriteHL },
+    OpInfo{ "MOV M,H", 1, Flow::None, Access::WriteHL },
+    OpInfo{ "MOV M,L", 1, Flow::None, Access::WriteHL },
+    OpInfo{ "HLT", 1, Flow::Halt, Access::None },
+    OpInfo{ "MOV M,A", 1, Flow::None, Access::WriteHL },
+    OpInfo{ "MOV A,B", 1, Flow::None, Access::None },
+    OpInfo{ "MOV A,C", 1, Flow::None, Access::None },
+    OpInfo{ "MOV A,D", 1, Flow::None, Access::None },
+    OpInfo{ "MOV A,E", 1, Flow::None, Access::None },
+    OpInfo{ "MOV A,H", 1, Flow::None, Access::None },
+    OpInfo{ "MOV A,L", 1, Flow::None, Access::None },
+    OpInfo{ "MOV A,M", 1, Flow::None, Access::ReadHL },
+    OpInfo{ "MOV A,A", 1, Flow::None, Access::None },
+    OpInfo{ "ADD B", 1, Flow::None, Access::None }, //0x80
+    OpInfo{ "ADD C", 1, Flow::None, Access::None },
+    OpInfo{ "ADD D", 1, Flow::None, Access::None },
+    OpInfo{ "ADD E", 1, Flow::None, Access::None },
+    OpInfo{ "ADD H", 1, Flow::None, Access::None },
+    OpInfo{ "ADD L", 1, Flow::None, Access::None },
+    OpInfo{ "ADD M", 1, Flow::None, Access::ReadHL },
+    OpInfo{ "ADD A", 1, Flow::None, Access::None },
+    OpInfo{ "ADC B", 1, Flow::None, Access::None },
+    OpInfo{ "ADC C", 1, Flow::None, Access::None },
+    OpInfo{ "ADC D", 1, Flow::None, Access::None },
+    OpInfo{ "ADC E", 1, Flow::None, Access::None },
+    OpInfo{ "ADC H", 1, Flow::None, Access::None },
+    OpInfo{ "ADC L", 1, Flow::None, Access::None },
+    OpInfo{ "ADC M", 1, Flow::None, Access::ReadHL },
+    OpInfo{ "ADC A", 1, Flow::None, Access::None },
+    OpInfo{ "SUB B", 1, Flow::None, Access::None }, //0x90
+    OpInfo{ "SUB C", 1, Flow::None, Access::None },
+    OpInfo{ "SUB D", 1, Flow::None, Access::None },
+    OpInfo{ "SUB E", 1, Flow::None, Access::None },
+    OpInfo{ "SUB H", 1, Flow::None, Access::None },
+    OpInfo{ "SUB L", 1, Flow::None, Access::None },
+    OpInfo{ "SUB M", 1, Flow::None, Access::ReadHL },
+    OpInfo{ "SUB A", 1, Flow::None, Access::None },
+    OpInfo{ "SBB B", 1, Flow::None, Access::None },
+    OpInfo{ "SBB C", 1, Flow::None, Access::None },
+    OpInfo{ "SBB D", 1, Flow::None, Access::None },
+    OpInfo{ "SBB E", 1, Flow::None, Access::None },
+    OpInfo{ "SBB H", 1, Flow::None, Access::None },
+    OpInfo{ "SBB L", 1, Flow::None, Access::None },
+    OpInfo{ "SBB M", 1, Flow::None, Access::ReadHL },
+    OpInfo{ "SBB A", 1, Flow::None, Access::None },
+    OpInfo{ "ANA B", 1, Flow::None, Access::None }, //0xA0
+    OpInfo{ "ANA C", 1, Flow::None, Access::None },
+    OpInfo{ "ANA D", 1, Flow::None, Access::None },
+    OpInfo{ "ANA E", 1, Flow::None, Access::None },
+    OpInfo{ "ANA H", 1, Flow::None, Access::None },
+    OpInfo{ "ANA L", 1, Flow::None, Access::None },
+    OpInfo{ "ANA M", 1, Flow::None, Access::ReadHL },
+    OpInfo{ "ANA A", 1, Flow::None, Access::None },
+    OpInfo{ "XRA B", 1, Flow::None, Access::None },
+    OpInfo{ "XRA C", 1, Flow::None, Access::None },
+    OpInfo{ "XRA D", 1, Flow::None, Access::None },
+    OpInfo{ "XRA E", 1, Flow::None, Access::None },
+    OpInfo{ "XRA H", 1, Flow::None, Access::None },
+    OpInfo{ "XRA L", 1, Flow::None, Access::None },
+    OpInfo{ "XRA M", 1, Flow::None, Access::ReadHL },
+    OpInfo{ "XRA A", 1, Flow::None, Access::None },
+    OpInfo{ "ORA B", 1, Flow::None, Access::None }, //0xB0
+    OpInfo{ "ORA C", 1, Flow::None, Access::None },
+    OpInfo{ "ORA D", 1, Flow::None, Access::None },
+    OpInfo{ "ORA E", 1, Flow::None, Access::None },
+    OpInfo{ "ORA H", 1, Flow::None, Access::None },
+    OpInfo{ "ORA L", 1, Flow::None, Access::None },
+    OpInfo{ "ORA M", 1, Flow::None, Access::ReadHL },
+    OpInfo{ "ORA A", 1, Flow::None, Access::None },
+    OpInfo{ "CMP B", 1, Flow::None, Access::None },
+    OpInfo{ "CMP C", 1, Flow::None, Access::None },
+    OpInfo{ "CMP D", 1, Flow::None, Access::None },
+    OpInfo{ "CMP E", 1, Flow::None, Access::None },
+    OpInfo{ "CMP H", 1, Flow::None, Access::None },
+    OpInfo{ "CMP L", 1, Flow::None, Access::None },
+    OpInfo{ "CMP M", 1, Flow::None, Access::ReadHL },
+    OpInfo{ "CMP A", 1, Flow::None, Access::None },
+    OpInfo{ "RNZ", 1, Flow::CondReturn, Access::Pop }, //0xC0
+    OpInfo{ "POP B", 1, Flow::None, Access::Pop },
+    OpInfo{ "JNZ a16", 3, Flow::CondJump, Access::None },
+    OpInfo{ "JMP a16", 3, Flow::Jump, Access::None },
+    OpInfo{ "CNZ a16", 3, Flow::CondCall, Access::Push },
+    OpInfo{ "PUSH B", 1, Flow::None, Access::Push },
+    OpInfo{ "ADI d8", 2, Flow::None, Access::None },
+    OpInfo{ "RST 0", 1, Flow::Restart, Access::Push },
+    OpInfo{ "RZ", 1, Flow::CondReturn, Access::Pop },
+    OpInfo{ "RET", 1, Flow::Return, Access::Pop },
+    OpInfo{ "JZ a16", 3, Flow::CondJump, Access::None },
+    OpInfo{ "*JMP a16", 3, Flow::Jump, Access::None },
+    OpInfo{ "CZ a16", 3, Flow::CondCall, Access::Push },
+    OpInfo{ "CALL a16", 3, Flow::Call, Access::Push },
+    OpInfo{ "ACI d8", 2, Flow::None, Access::None },
+    OpInfo{ "RST 1", 1, Flow::Restart, Access::Push },
+    OpInfo{ "RNC", 1, Flow::CondReturn, Access::Pop }, //0xD0
+    OpInfo{ "POP D", 1, Flow::None, Access::Pop },
+    OpInfo{ "JNC a16", 3, Flow::CondJump, Access::None },
+    OpInfo{ "OUT d8", 2, Flow::None, Access::None },
+    OpInfo{ "CNC a16", 3, Flow::CondCall, Access::Push },
+    OpInfo{ "PUSH D", 1, Flow::None, Access::Push },
+    OpInfo{ "SUI d8", 2, Flow::None, Access::None },
+    OpInfo{ "RST 2", 1, Flow::Restart, Access::Push },
+    OpInfo{ "RC", 1, Flow::CondReturn, Access::Pop },
+    OpInfo{ "*RET", 1, Flow::Return, Access::Pop },
+    OpInfo{ "JC a16", 3, Flow::CondJump, Access::None },
+    OpInfo{ "IN d8", 2, Flow::None, Access::None },
+    OpInfo{ "CC a16", 3, Flow::CondCall, Access::Push },
+    OpInfo{ "*CALL a16", 3, Flow::Call, Access::Push },
+    OpInfo{ "SBI d8", 2, Flow::None, Access::None },
+    OpInfo{ "RST 3", 1, Flow::Restart, Access::Push },
+    OpInfo{ "RPO", 1, Flow::CondReturn, Access::Pop }, //0xE0
+    OpInfo{ "POP H", 1, Flow::None, Access::Pop },
+    OpInfo{ "JPO a16", 3, Flow::CondJump, Access::None },
+    OpInfo{ "XTHL", 1, Flow::None, Access::ExchangeStack },
+    OpInfo{ "CPO a16", 3, Flow::CondCall, Access::Push },
+    OpInfo{ "PUSH H", 1, Flow::None, Access::Push },
+    OpInfo{ "ANI d8", 2, Flow::None, Access::None },
+    OpInfo{ "RST 4", 1, Flow::Restart, Access::Push },
+    OpInfo{ "RPE", 1, Flow::CondReturn, Access::Pop },
+    OpInfo{ "PCHL", 1, Flow::Jump, Access::None },
+    OpInfo{ "JPE a16", 3, Flow::CondJump, Access::None },
+    OpInfo{ "XCHG", 1, Flow::None, Access::None },
+    OpInfo{ "CPE a16", 3, Flow::CondCall, Access::Push },
+    OpInfo{ "*CALL a16", 3, Flow::Call, Access::Push },
+    OpInfo{ "XRI d8", 2, Flow::None, Access::None },
+    OpInfo{ "RST 5", 1, Flow::Restart, Access::Push },
+    OpInfo{ "RP", 1, Flow::CondReturn, Access::Pop }, //0xF0
+    OpInfo{ "POP PSW", 1, Flow::None, Access::Pop },
+    OpInfo{ "JP a16", 3, Flow::CondJump, Access::None },
+    OpInfo{ "DI", 1, Flow::None, Access::None },
+    OpInfo{ "CP a16", 3, Flow::CondCall, Access::Push },
+    OpInfo{ "PUSH PSW", 1, Flow::None, Access::Push },
+    OpInfo{ "ORI d8", 2, Flow::None, Access::None },
+    OpInfo{ "RST 6", 1, Flow::Restart, Access::Push },
+    OpInfo{ "RM", 1, Flow::CondReturn, Access::Pop },
+    OpInfo{ "SPHL", 1, Flow::None, Access::None },
+    OpInfo{ "JM a16", 3, Flow::CondJump, Access::None },
+    OpInfo{ "EI", 1, Flow::None, Access::None },
+    OpInfo{ "CM a16", 3, Flow::CondCall, Access::Push },
+    OpInfo{ "*CALL a16", 3, Flow::Call, Access::Push },
+    OpInfo{ "CPI d8", 2, Flow::None, Access::None },
+    OpInfo{ "RST 7", 1, Flow::Restart, Access::Push }
+};
+
+//these seem to vary depending on hardware info source...
+const std::array<std::uint8_t, 256> I8080::opCycles =
+{
+    4,  10, 7,  5,  5,  5,  7,  4,  4 , 10, 7,  5,  5,  5,  7,  4,
+    4,  10, 7,  5,  5,  5,  7,  4,  4,  10, 7,  5,  5,  5,  7,  4, 
+    4,  10, 16, 5,  5,  5,  7,  4,  4,  10, 16, 5,  5,  5,  7,  4,
+    4,  10, 13, 5,  10, 10, 10, 4,  4,  10, 13, 5,  5,  5,  7,  4,
+    5,  5,  5,  5,  5,  5,  7,  5,  5,  5,  5,  5,  5,  5,  7,  5,
+    5,  5,  5,  5,  5,  5,  7,  5,  5,  5,  5,  5,  5,  5,  7,  5,
+    5,  5,  5,  5,  5,  5,  7,  5,  5,  5,  5,  5,  5,  5,  7,  5,
+    7,  7,  7,  7,  7,  7,  7,  7,  5,  5,  5,  5,  5,  5,  7,  5,
+    4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+    4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+    4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+    4,  4,  4,  4,  4,  4,  7,  4,  4,  4,  4,  4,  4,  4,  7,  4,
+    11, 10, 10, 10, 17, 11, 7,  11, 11, 10, 10, 10, 10, 17, 7,  11,
+    11, 10, 10, 10, 17, 11, 7,  11, 11, 10, 10, 10, 10, 17, 7,  11,
+    11, 10, 10, 18, 17, 11, 7,  11, 11, 5,  10, 5,  17, 17, 7,  11,
+    11, 10, 10, 4,  17, 11, 7,  11, 11, 5,  10, 4,  17, 17, 7,  11
+};
\ No newline at end of file
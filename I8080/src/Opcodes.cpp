@@ -22,6 +22,7 @@ source distribution.
 *********************************************************************/
 
 #include <I8080/I8080.hpp>
+#include <I8080/OpInfo.hpp>
 
 #include <cassert>
 
@@ -45,9 +46,7 @@ void CPU::setParity(std::int16_t value)
 void CPU::notImpl()
 {
     //throw("Opcode not implemented, or illegal");
-#ifdef DEBUG_TOOLS
-    auto a = m_disassembly[m_registers.programCounter];
-#endif //DEBUG_TOOLS
+    //getDisassembler().getLine() describes the offending instruction
 }
 
 //----8 bit transfer instructions----//
@@ -1838,4 +1837,118 @@ void CPU::mvim()
 {
     m_memory[m_registers.HL] = m_memory[m_registers.programCounter + 1];
     m_registers.programCounter += 2;
+}
+
+//----fused sequences----//
+void CPU::retire(Byte next)
+{
+    m_cycleCount -= opCycles[m_currentOpcode];
+    m_instructionCount++;
+    m_currentOpcode = next;
+}
+
+bool CPU::storesIntoRun(Word address, Word length) const
+{
+    //a run which would overwrite its own later opcodes
+    //has to see the new ones, so isn't fused
+    return static_cast<Word>(address - m_registers.programCounter) < length;
+}
+//0x01 0x09 0xC1 LXI B; DAD B; POP B, stepping HL to the next row. The
+//step is never stored in BC as the pop replaces it straight away
+void CPU::lxibDadbPopb()
+{
+    const std::int32_t result = m_registers.HL + getWord(m_registers.programCounter + 1);
+
+    m_flags.cy = (result > 0xFFFF);
+    m_registers.HL = result & 0xFFFF;
+    m_registers.BC = popWord();
+    m_registers.programCounter += 5;
+    retire(0x09);
+    retire(0xC1);
+}
+//0xD3 0xDB 0xB6 OUT; IN; ORA M, merging a shifted byte into the screen.
+//Each instruction is retired before the next port access so the IO
+//handlers see the same cycle count as they would unfused
+void CPU::outInOram()
+{
+    const Word programCounter = m_registers.programCounter;
+    handleOutput(m_memory[programCounter + 1], m_registers.A);
+    retire(0xDB);
+    const Byte value = handleInput(m_memory[programCounter + 3]);
+    retire(0xB6);
+
+    //bitlogic() steps over the ORA
+    m_registers.programCounter += 4;
+    bitlogic(value | m_memory[m_registers.M]);
+}
+//0x77 0x23 0x13 MOV M,A; INX H; INX D
+void CPU::movmaInxhInxd()
+{
+    if (storesIntoRun(m_registers.M, 3))
+    {
+        movma();
+        return;
+    }
+
+    m_memory[m_registers.M] = m_registers.A;
+    m_registers.HL++;
+    m_registers.DE++;
+    m_registers.programCounter += 3;
+    retire(0x23);
+    retire(0x13);
+}
+//0x77 0x23 MOV M,A; INX H
+void CPU::movmaInxh()
+{
+    if (storesIntoRun(m_registers.M, 2))
+    {
+        movma();
+        return;
+    }
+
+    m_memory[m_registers.M] = m_registers.A;
+    m_registers.HL++;
+    m_registers.programCounter += 2;
+    retire(0x23);
+}
+//0x05 0xC2 DCR B; JNZ
+void CPU::dcrbJnz()
+{
+    const std::int16_t result = m_registers.B - 1;
+    inc8(result, m_registers.B);
+    m_registers.B = result & 0xFF;
+
+    m_registers.programCounter = (!m_flags.z) ? getWord(m_registers.programCounter + 2) : m_registers.programCounter + 4;
+    retire(0xC2);
+}
+//0xC5 0xE5 PUSH B; PUSH H
+void CPU::pushbPushh()
+{
+    const Word stackPointer = m_registers.stackPointer;
+    if (storesIntoRun(stackPointer - 1, 2) || storesIntoRun(stackPointer - 2, 2))
+    {
+        pushb();
+        return;
+    }
+
+    pushWord(m_registers.BC);
+    pushWord(m_registers.HL);
+    m_registers.programCounter += 2;
+    retire(0xE5);
+}
+//0x1A 0x77 LDAX D; MOV M,A
+void CPU::ldaxdMovma()
+{
+    m_registers.A = m_memory[m_registers.DE];
+    m_memory[m_registers.M] = m_registers.A;
+    m_registers.programCounter += 2;
+    retire(0x77);
+}
+//0x23 0x13 INX H; INX D
+void CPU::inxhInxd()
+{
+    m_registers.HL++;
+    m_registers.DE++;
+    m_registers.programCounter += 2;
+    retire(0x13);
 }
\ No newline at end of file
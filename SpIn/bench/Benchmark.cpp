@@ -0,0 +1,388 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//microbenchmarks for the CPU core and the hot paths around it. Each
+//benchmark is run for a number of samples and reported as nanoseconds
+//per operation, so the effect of a change to Opcodes.cpp or Display.cpp
+//can be measured. Needs no window or audio device.
+//
+//usage: spin_bench [--samples <count>] [--filter <text>] [--format table|csv|json]
+
+#include <Board.hpp>
+#include <Compositor.hpp>
+#include <Display.hpp>
+#include <Synth.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const std::size_t DefaultSamples = 15;
+    const std::int32_t CyclesPerSample = 2000000; //about a second of guest time
+    const std::uint64_t FramesPerSample = 500;
+    const std::uint64_t CopiesPerSample = 200;
+    const std::uint32_t AudioRate = 44100;
+    const std::uint32_t AudioFrame = AudioRate / 60;
+
+    const std::size_t BodyRepeats = 16;
+    const Word StackTop = 0x2400; //top of work RAM
+    const Word DataAddress = 0x2100;
+
+    //the shift register wiring of the Midway boards, without any ROMs
+    const char* const BenchMachine =
+        "in 3 shift-result\n"
+        "out 2 shift-offset\n"
+        "out 4 shift-data\n"
+        "interrupt top 17000 1\n"
+        "interrupt bottom 33333 2\n";
+
+    //assembles a loop of the same block of instructions
+    class Program final
+    {
+    public:
+        Program()
+        {
+            //registers used as operands by the blocks
+            emit({ 0x21, DataAddress & 0xFF, DataAddress >> 8 }); //LXI H
+            emit({ 0x01, 0x01, 0x02 }); //LXI B
+            emit({ 0x11, 0x03, 0x04 }); //LXI D
+            m_loop = here();
+        }
+
+        void emit(std::initializer_list<Byte> bytes)
+        {
+            m_code.insert(m_code.end(), bytes);
+        }
+
+        void emit(Byte opcode, Word address)
+        {
+            emit({ opcode, static_cast<Byte>(address & 0xFF), static_cast<Byte>(address >> 8) });
+        }
+
+        Word here() const { return static_cast<Word>(m_code.size()); }
+
+        const std::vector<Byte>& finish()
+        {
+            emit(0xC3, m_loop); //JMP
+            return m_code;
+        }
+
+    private:
+        std::vector<Byte> m_code;
+        Word m_loop = 0;
+    };
+
+    using Block = std::function<void(Program&)>;
+
+    std::vector<Byte> assemble(const Block& block)
+    {
+        Program program;
+        for (auto i = 0u; i < BodyRepeats; ++i)
+        {
+            block(program);
+        }
+        return program.finish();
+    }
+
+    void movBlock(Program& p)
+    {
+        p.emit({ 0x41, 0x53, 0x78, 0x4F, 0x5A, 0x7B, 0x77, 0x7E }); //MOV B,C D,E A,B C,A E,D A,E M,A A,M
+    }
+
+    void aluBlock(Program& p)
+    {
+        p.emit({ 0x80, 0x89, 0x92, 0x9B, 0xA4, 0xAD, 0xB0, 0xB9 }); //ADD B, ADC C, SUB D, SBB E, ANA H, XRA L, ORA B, CMP C
+        p.emit({ 0xC6, 0x03, 0xE6, 0x7F, 0x3C, 0x15, 0x07, 0x1F, 0x27, 0x2F }); //ADI, ANI, INR A, DCR D, RLC, RAR, DAA, CMA
+    }
+
+    //taken and untaken branches which land on the next instruction
+    void branchBlock(Program& p)
+    {
+        p.emit({ 0xAF }); //XRA A, sets Z
+        p.emit(0xCA, p.here() + 3); //JZ, taken
+        p.emit(0xC2, p.here() + 3); //JNZ, not taken
+        p.emit({ 0xF6, 0x01 }); //ORI 1, clears Z
+        p.emit(0xC2, p.here() + 3); //JNZ, taken
+        p.emit(0xCC, 0); //CZ, not taken
+        p.emit(0xCD, p.here() + 6); //CALL the RNZ below
+        p.emit(0xC3, p.here() + 4); //JMP past it on return
+        p.emit({ 0xC0 }); //RNZ, taken
+    }
+
+    void stackBlock(Program& p)
+    {
+        p.emit({ 0xC5, 0xD5, 0xE5, 0xF5, 0xE3, 0xE3, 0xF1, 0xE1, 0xD1, 0xC1 }); //PUSH B D H PSW, XTHL x2, POP PSW H D B
+    }
+
+    //the shift register is written twice and offset once for each read
+    void shiftBlock(Program& p)
+    {
+        p.emit({ 0x3E, 0xA5, 0xD3, 0x04 }); //MVI A, OUT 4
+        p.emit({ 0x3E, 0x5A, 0xD3, 0x04 }); //MVI A, OUT 4
+        p.emit({ 0x3E, 0x03, 0xD3, 0x02 }); //MVI A, OUT 2
+        p.emit({ 0xDB, 0x03 }); //IN 3
+    }
+
+    //a copy loop like those used to draw sprites
+    void copyBlock(Program& p)
+    {
+        p.emit({ 0x06, 0x20 }); //MVI B
+        p.emit(0x21, DataAddress); //LXI H
+        p.emit(0x11, 0x0000); //LXI D
+        const auto loop = p.here();
+        p.emit({ 0x1A, 0x77, 0x23, 0x13, 0x05 }); //LDAX D, MOV M,A, INX H, INX D, DCR B
+        p.emit(0xC2, loop); //JNZ
+    }
+
+    struct Result final
+    {
+        std::string name;
+        std::string op;
+        std::size_t samples = 0;
+        std::uint64_t opsPerSample = 0;
+        double min = 0.0;
+        double median = 0.0;
+        double mean = 0.0;
+        double stdDev = 0.0;
+    };
+
+    //runs one discarded warm up sample, then times each sample.
+    //the function runs a sample and returns the number of ops done
+    Result measure(const std::string& name, const std::string& op, std::size_t samples, const std::function<std::uint64_t()>& sample)
+    {
+        sample();
+
+        std::vector<double> times;
+        std::uint64_t ops = 0;
+        for (auto i = 0u; i < samples; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            ops = sample();
+            const auto end = std::chrono::steady_clock::now();
+            const auto ns = std::chrono::duration<double, std::nano>(end - start).count();
+            times.push_back(ns / std::max<std::uint64_t>(ops, 1));
+        }
+        std::sort(times.begin(), times.end());
+
+        Result result;
+        result.name = name;
+        result.op = op;
+        result.samples = samples;
+        result.opsPerSample = ops;
+        result.min = times.front();
+        result.median = (samples % 2) ? times[samples / 2] : (times[samples / 2 - 1] + times[samples / 2]) / 2.0;
+        for (auto t : times) result.mean += t;
+        result.mean /= samples;
+        for (auto t : times) result.stdDev += (t - result.mean) * (t - result.mean);
+        result.stdDev = (samples > 1) ? std::sqrt(result.stdDev / (samples - 1)) : 0.0;
+        return result;
+    }
+
+    //copies the program to the start of memory and jumps to it
+    void loadProgram(Board& board, Board::State& state, const std::vector<Byte>& code)
+    {
+        board.saveState(state);
+        std::copy(code.begin(), code.end(), state.processor.memory.begin());
+        state.processor.programCounter = 0;
+        state.processor.stackPointer = StackTop;
+        state.processor.interruptEnabled = false;
+        board.loadState(state);
+    }
+
+    void printResults(const std::vector<Result>& results, const std::string& format)
+    {
+        if (format == "csv")
+        {
+            std::printf("name,op,samples,ops_per_sample,min_ns,median_ns,mean_ns,stddev_ns\n");
+            for (const auto& r : results)
+            {
+                std::printf("%s,%s,%zu,%llu,%.3f,%.3f,%.3f,%.3f\n", r.name.c_str(), r.op.c_str(), r.samples,
+                    static_cast<unsigned long long>(r.opsPerSample), r.min, r.median, r.mean, r.stdDev);
+            }
+        }
+        else if (format == "json")
+        {
+            std::printf("[\n");
+            for (auto i = 0u; i < results.size(); ++i)
+            {
+                const auto& r = results[i];
+                std::printf("  { \"name\": \"%s\", \"op\": \"%s\", \"samples\": %zu, \"ops_per_sample\": %llu, "
+                    "\"min_ns\": %.3f, \"median_ns\": %.3f, \"mean_ns\": %.3f, \"stddev_ns\": %.3f }%s\n",
+                    r.name.c_str(), r.op.c_str(), r.samples, static_cast<unsigned long long>(r.opsPerSample),
+                    r.min, r.median, r.mean, r.stdDev, (i + 1 < results.size()) ? "," : "");
+            }
+            std::printf("]\n");
+        }
+        else
+        {
+            std::printf("%-20s %-12s %12s %12s %12s %12s\n", "benchmark", "op", "min ns", "median ns", "mean ns", "stddev");
+            for (const auto& r : results)
+            {
+                std::printf("%-20s %-12s %12.3f %12.3f %12.3f %12.3f\n", r.name.c_str(), r.op.c_str(), r.min, r.median, r.mean, r.stdDev);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t samples = DefaultSamples;
+    std::string filter;
+    std::string format = "table";
+    for (auto i = 1; i < argc; ++i)
+    {
+        std::string arg(argv[i]);
+        if (arg == "--samples" && i + 1 < argc) samples = std::max<std::size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--filter" && i + 1 < argc) filter = argv[++i];
+        else if (arg == "--format" && i + 1 < argc) format = argv[++i];
+        else
+        {
+            std::printf("Usage: spin_bench [--samples <count>] [--filter <text>] [--format table|csv|json]\n");
+            return 1;
+        }
+    }
+
+    //the board and snapshot each hold a copy of memory so live on the heap
+    auto board = std::make_unique<Board>();
+    auto state = std::make_unique<Board::State>();
+    auto& cpu = board->getProcessor();
+
+    MachineDefinition definition;
+    std::istringstream definitionStream(BenchMachine);
+    definition.loadFromStream(definitionStream, "bench");
+    board->setDefinition(definition);
+
+    std::vector<Result> results;
+    auto run = [&](const std::string& name, const std::string& op, const std::function<std::uint64_t()>& sample)
+    {
+        if (name.find(filter) != std::string::npos)
+        {
+            results.push_back(measure(name, op, samples, sample));
+        }
+    };
+
+    //instruction mixes, run through the board so I/O takes the same path as a game
+    const std::vector<std::pair<std::string, Block>> mixes =
+    {
+        { "cpu-mov", movBlock },
+        { "cpu-alu", aluBlock },
+        { "cpu-branch", branchBlock },
+        { "cpu-stack", stackBlock },
+        { "cpu-shift-io", shiftBlock },
+        { "cpu-copy", copyBlock }
+    };
+    //each is run with and without fused runs for comparison
+    for (const auto& mix : mixes)
+    {
+        const auto code = assemble(mix.second);
+        for (auto features : { 0u, static_cast<std::uint32_t>(I8080::CPU::Fusion) })
+        {
+            const auto name = (features & I8080::CPU::Fusion) ? mix.first + "-fused" : mix.first;
+            run(name, "instruction", [&]()
+            {
+                cpu.setFeatures(features);
+                loadProgram(*board, *state, code);
+                const auto count = cpu.getInstructionCount();
+                cpu.update(CyclesPerSample);
+                return cpu.getInstructionCount() - count;
+            });
+        }
+    }
+
+    //expands a full frame of noise
+    std::vector<std::uint8_t> vram(I8080::VRAM_SIZE);
+    std::vector<std::uint8_t> rgba(256 * 224 * 4);
+    std::mt19937 rng(1234);
+    std::generate(vram.begin(), vram.end(), [&rng]() {return static_cast<std::uint8_t>(rng()); });
+    run("display-convert", "frame", [&]()
+    {
+        for (auto i = 0u; i < FramesPerSample; ++i)
+        {
+            Display::convertRows(vram.data(), rgba.data(), 0, 224);
+        }
+        return FramesPerSample;
+    });
+
+    //the software CRT used when recording, on one thread so the
+    //per pixel cost is measured rather than the core count
+    auto compositor = std::make_unique<Compositor>(std::vector<Overlay::Region>(), 1u, 1u);
+    auto time = 0.f;
+    run("compositor", "frame", [&]()
+    {
+        for (auto i = 0u; i < FramesPerSample; ++i)
+        {
+            compositor->update(vram.data(), time);
+            time += 1.f / 60.f;
+        }
+        return FramesPerSample;
+    });
+
+    //a second of audio with every circuit sounding, which is the
+    //worst case cost of one cabinet's sound board as a share of a core
+    auto synth = std::make_unique<Synth>(AudioRate);
+    std::vector<std::int32_t> audio(AudioRate);
+    run("synth-render", "second", [&]()
+    {
+        synth->setGate(Sound::UFO, true);
+        synth->setGate(Sound::ExtendedPlay, true);
+        for (auto i = 0u; i < AudioRate / AudioFrame; ++i)
+        {
+            //the one shots are retriggered so none of them decay to silence
+            if (i % 10 == 0)
+            {
+                for (auto id : { Sound::Shot, Sound::ShipHit, Sound::InvaderHit, Sound::MotherShip })
+                {
+                    synth->setGate(id, true);
+                }
+                synth->setGate(Sound::Invader0 + (i / 10) % 4, true);
+            }
+            synth->render(&audio[i * AudioFrame], AudioFrame);
+        }
+        return std::uint64_t(1);
+    });
+
+    //a save followed by a restore, as done for each run ahead frame
+    run("save-state", "save+load", [&]()
+    {
+        for (auto i = 0u; i < CopiesPerSample; ++i)
+        {
+            board->saveState(*state);
+            board->loadState(*state);
+        }
+        return CopiesPerSample;
+    });
+
+    printResults(results, format);
+    return 0;
+}
\ No newline at end of file
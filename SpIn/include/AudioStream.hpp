@@ -0,0 +1,83 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef SP_AUDIO_STREAM_HPP_
+#define SP_AUDIO_STREAM_HPP_
+
+#include <SFML/Audio/SoundStream.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/*!
+\brief Plays mixed PCM through a single sound stream.
+The emulation thread pushes blocks of samples into a single
+producer, single consumer ring buffer which the audio thread
+drains without locking. Underruns are padded with silence
+so the stream never stops.
+*/
+class AudioStream final : public sf::SoundStream
+{
+public:
+    static constexpr std::size_t Capacity = 8192u; //!< in samples, must be a power of 2
+    static constexpr std::size_t ChunkSize = 512u; //!< samples handed to the audio device at a time
+
+    explicit AudioStream(std::uint32_t sampleRate);
+    ~AudioStream();
+    AudioStream(const AudioStream&) = delete;
+    AudioStream& operator = (const AudioStream&) = delete;
+
+    /*!
+    \brief Queues mono samples for playback. Called from the
+    emulation thread only.
+    \returns The number of samples queued, which is less than
+    requested if the buffer is full
+    */
+    std::size_t push(const std::int16_t*, std::size_t);
+
+    /*!
+    \brief Returns the number of samples waiting to be played
+    */
+    std::size_t getQueuedCount() const;
+
+    /*!
+    \brief Returns the number of times the audio thread ran
+    out of samples
+    */
+    std::uint64_t getUnderrunCount() const { return m_underrunCount; }
+
+private:
+    std::vector<std::int16_t> m_buffer;
+    std::vector<std::int16_t> m_chunk;
+
+    //positions only ever increase, and are masked on access
+    std::atomic<std::size_t> m_readPosition;
+    std::atomic<std::size_t> m_writePosition;
+    std::atomic<std::uint64_t> m_underrunCount;
+
+    bool onGetData(Chunk&) override;
+    void onSeek(sf::Time) override {}
+};
+
+#endif //SP_AUDIO_STREAM_HPP_
\ No newline at end of file
@@ -0,0 +1,220 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef SP_BOARD_HPP_
+#define SP_BOARD_HPP_
+
+#include <I8080/I8080.hpp>
+
+#include <MachineDefinition.hpp>
+
+class InputState;
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*!
+\brief The Midway 8080 board hardware: CPU, I/O ports, the
+shift register and the interrupt schedule, wired up by the
+MachineDefinition of the loaded game. Has no dependency on
+windowing, graphics or audio so it can be run headless.
+*/
+class Board final
+{
+public:
+    /*!
+    \brief Halves of the raster, in scan order
+    */
+    enum class Half
+    {
+        Top,
+        Bottom
+    };
+
+    //33,333 * 60 = 1,999,980
+    //as close as we get to 2MHz
+    static constexpr std::int32_t CyclesPerFrame = 33333;
+    static constexpr std::int32_t FramesPerSecond = 60;
+
+    /*!
+    \brief Called when the beam leaves each half of the
+    screen, with a pointer to VRAM. This is the point at
+    which that half is guaranteed not to be mid-update.
+    */
+    using RasterHandler = std::function<void(const Byte*, Half)>;
+
+    /*!
+    \brief Called when a sound output bit wired to a sound
+    changes. Receives the sound ID, whether the sound
+    started or stopped and the CPU cycle count at which
+    the change was made.
+    */
+    using SoundHandler = std::function<void(std::int32_t, bool, std::uint64_t)>;
+
+    /*!
+    \brief Snapshot of the board, including the CPU and memory
+    */
+    struct State final
+    {
+        I8080::CPU::State processor;
+        std::array<Byte, I8080::PORT_COUNT> ports = {};
+        Word shiftValue = 0;
+        Word shiftOffset = 0;
+        std::uint64_t frameCount = 0;
+        std::uint64_t frameStartCycle = 0;
+        Half half = Half::Top;
+        std::int32_t halfCycles = 0;
+    };
+
+    /*!
+    \brief A ROM chip mapped into memory by loadGame()
+    */
+    struct RomChip final
+    {
+        std::string path;
+        Word address = 0;
+        Word size = 0;
+    };
+
+    /*!
+    \brief Called when the guest reads a controls port,
+    with the number of the port and the value read
+    */
+    using PortReadHandler = std::function<void(std::size_t, Byte)>;
+
+    Board();
+    ~Board() = default;
+    Board(const Board&) = delete;
+    Board& operator = (const Board&) = delete;
+
+    /*!
+    \brief Loads the machine definition of the given game, eg
+    invaders, maps its ROMs and resets the CPU
+    \returns false if the definition or any of the ROMs failed to
+    load, in which case no game is loaded and update() does nothing
+    */
+    bool loadGame(const std::string& name);
+
+    /*!
+    \brief Wires up the board's devices and interrupts without
+    loading any ROMs, for programs placed directly in memory
+    */
+    void setDefinition(const MachineDefinition&);
+
+    /*!
+    \brief Emulates a single 60Hz frame. Does nothing
+    until a game has been loaded.
+    \returns false if the CPU's debugger stopped it part way
+    through the frame, in which case the next call resumes
+    the frame from where it stopped
+    */
+    bool update();
+
+    void setRasterHandler(const RasterHandler& rh) { m_rasterHandler = rh; }
+    void setSoundHandler(const SoundHandler& sh) { m_soundHandler = sh; }
+    void setPortReadHandler(const PortReadHandler& ph) { m_portReadHandler = ph; }
+
+    /*!
+    \brief Attaches controls which are read at the moment the
+    guest reads a controls port. These are combined with any bits
+    set with setFlag(). Pass nullptr to detach.
+    */
+    void setInputState(const InputState* is) { m_inputState = is; }
+
+    /*!
+    \brief Sets the given bit of an input port
+    */
+    void setFlag(std::size_t, Byte);
+    /*!
+    \brief Clears the given bit of an input port
+    */
+    void unsetFlag(std::size_t, Byte);
+
+    /*!
+    \brief Saves the state of the board between frames
+    */
+    void saveState(State&) const;
+    /*!
+    \brief Restores a state saved with saveState()
+    */
+    void loadState(const State&);
+
+    const Byte* getVRAM() const { return m_processor.getVRAM(); }
+
+    I8080::CPU& getProcessor() { return m_processor; }
+    const I8080::CPU& getProcessor() const { return m_processor; }
+
+    /*!
+    \brief Returns the definition of the game last loaded
+    */
+    const MachineDefinition& getDefinition() const { return m_definition; }
+
+    /*!
+    \brief Returns the ROM chips mapped by the last call to loadGame()
+    */
+    const std::vector<RomChip>& getRomChips() const { return m_romChips; }
+
+    /*!
+    \brief Returns the number of frames emulated since the last game was loaded
+    */
+    std::uint64_t getFrameCount() const { return m_frameCount; }
+
+    /*!
+    \brief Returns how far through the current frame the given
+    cycle count is, in the range 0 - 1. Useful for placing
+    sound events within a block of audio samples.
+    */
+    float getFramePosition(std::uint64_t) const;
+
+private:
+    I8080::CPU m_processor;
+    MachineDefinition m_definition;
+
+    std::array<Byte, I8080::PORT_COUNT> m_ports;
+
+    Word m_shiftValue;
+    Word m_shiftOffset;
+
+    std::uint64_t m_frameCount;
+    std::uint64_t m_frameStartCycle;
+    Half m_half; //half currently being emulated
+    std::int32_t m_halfCycles; //cycles remaining in the current half, 0 between frames
+
+    std::vector<RomChip> m_romChips;
+
+    const InputState* m_inputState;
+
+    RasterHandler m_rasterHandler;
+    SoundHandler m_soundHandler;
+    PortReadHandler m_portReadHandler;
+
+    bool loadChip(const MachineDefinition::Rom&, bool reset);
+    bool updateHalf();
+    Byte readInput(std::size_t) const;
+    void updateSound(std::size_t, Byte);
+};
+
+#endif //SP_BOARD_HPP_
@@ -0,0 +1,124 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef SP_COMPOSITOR_HPP_
+#define SP_COMPOSITOR_HPP_
+
+#include <Overlay.hpp>
+
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/*!
+\brief Software implementation of the overlay, background
+blend and CRT post process performed by Display's shaders.
+Produces the final rotated image from a VRAM pointer without
+requiring a GL context, so it can be used on headless machines.
+*/
+class Compositor final
+{
+public:
+    /*!
+    \brief Constructor.
+    \param overlay Regions of the cabinet's overlay, from the
+    definition of the game being composited
+    \param scale Integer scale of the output image relative to
+    the native 224x256 resolution. The CRT effects are evaluated
+    per output pixel, just as the post shader is per fragment.
+    \param threadCount Number of threads to split rows across.
+    Zero uses the number of hardware threads available.
+    */
+    explicit Compositor(const std::vector<Overlay::Region>& overlay, std::uint32_t scale = 1u, std::uint32_t threadCount = 0u);
+    ~Compositor();
+
+    Compositor(const Compositor&) = delete;
+    Compositor& operator = (const Compositor&) = delete;
+
+    /*!
+    \brief Composites the given VRAM buffer.
+    \param time Time in seconds used to animate the noise
+    and scanlines, equivalent to the shader's u_time
+    \returns Pointer to the RGBA output pixels
+    */
+    const std::uint8_t* update(const std::uint8_t* vram, float time);
+
+    /*!
+    \brief Returns the RGBA pixels of the most recent update
+    */
+    const std::uint8_t* getPixels() const { return m_output.data(); }
+
+    std::uint32_t getWidth() const { return m_width; }
+    std::uint32_t getHeight() const { return m_height; }
+
+private:
+    std::uint32_t m_width;
+    std::uint32_t m_height;
+
+    //colour of each source pixel when lit or unlit, with the
+    //overlay and background already blended in
+    std::vector<std::uint32_t> m_litColours;
+    std::vector<std::uint32_t> m_unlitColours;
+    std::vector<std::uint32_t> m_blended;
+
+    //per output pixel lookups which don't change over time
+    std::vector<std::uint32_t> m_redIndices;
+    std::vector<std::uint32_t> m_greenIndices;
+    std::vector<std::uint32_t> m_blueIndices;
+    std::vector<float> m_lineSin;
+    std::vector<float> m_lineCos;
+    std::vector<float> m_grainSeed;
+
+    std::vector<std::uint8_t> m_output;
+
+    void buildBlendTables(const std::vector<Overlay::Region>&);
+    void buildPostTables(std::uint32_t);
+
+    void blendRows(const std::uint8_t*, std::uint32_t, std::uint32_t);
+    void postRows(float, std::uint32_t, std::uint32_t);
+    void processBand(std::uint32_t);
+
+    //worker threads each process a band of rows
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_startCondition;
+    std::condition_variable m_doneCondition;
+    std::uint32_t m_generation;
+    std::uint32_t m_pendingCount;
+    bool m_running;
+
+    enum class Stage
+    {
+        Blend,
+        Post
+    }m_stage;
+    const std::uint8_t* m_vram;
+    float m_time;
+
+    void threadFunc(std::uint32_t);
+    void runStage(Stage);
+};
+
+#endif //SP_COMPOSITOR_HPP_
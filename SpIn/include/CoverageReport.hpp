@@ -0,0 +1,53 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef SP_COVERAGE_REPORT_HPP_
+#define SP_COVERAGE_REPORT_HPP_
+
+#include <string>
+
+class Board;
+
+/*!
+Writes the CPU's coverage map, collected while its Coverage
+feature is enabled, in forms which can be inspected
+*/
+namespace CoverageReport
+{
+    /*!
+    \brief Writes a CSV of how much of each ROM chip mapped by
+    the board has been executed, followed by the RAM regions
+    \returns false if the file couldn't be written
+    */
+    bool writeRegions(const Board&, const std::string& path);
+
+    /*!
+    \brief Saves a 256x256 heatmap image, one pixel per address.
+    Red shows writes, green reads and blue executed code. The
+    format is chosen from the file extension, eg png or bmp
+    \returns false if the image couldn't be saved
+    */
+    bool writeHeatmap(const Board&, const std::string& path);
+}
+
+#endif //SP_COVERAGE_REPORT_HPP_
\ No newline at end of file
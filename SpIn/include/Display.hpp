@@ -31,7 +31,10 @@ source distribution.
 #include <SFML/Graphics/RenderTexture.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 
+#include <Overlay.hpp>
+
 #include <array>
+#include <vector>
 
 class Display final : public sf::Drawable
 {
@@ -42,8 +45,44 @@ public:
     Display(const Display&) = delete;
     Display& operator = (const Display&) = delete;
 
+    /*!
+    \brief Halves of the raster, in scan order. The monitor
+    is mounted on its side so the top half of the raster
+    is the first half of VRAM
+    */
+    enum class Half
+    {
+        Top,
+        Bottom
+    };
+
+    /*!
+    \brief Replaces the overlay multiplied over the screen,
+    with the regions of the loaded game's definition
+    */
+    void setOverlay(const std::vector<Overlay::Region>&);
+
+    /*!
+    \brief Converts and uploads the entire VRAM buffer
+    */
     void updateBuffer(const std::uint8_t*);
 
+    /*!
+    \brief Converts and uploads only the given half of
+    the VRAM buffer. Used to capture each half of the
+    screen at the interrupt at which the beam leaves it
+    */
+    void updateBuffer(const std::uint8_t*, Half);
+
+    /*!
+    \brief Expands the given rows of VRAM to RGBA pixels without
+    uploading them, so conversion can be measured without a window
+    \param vram The VRAM buffer, 1 bit per pixel
+    \param rgba Destination with room for 256 * 224 * 4 bytes. Rows
+    are written to the same offset they are read from in VRAM
+    */
+    static void convertRows(const std::uint8_t* vram, std::uint8_t* rgba, std::uint32_t start, std::uint32_t count);
+
 private:
     sf::Texture m_baseTexture;
     sf::Texture m_overlayTexture;
@@ -57,6 +96,7 @@ private:
     sf::Sprite m_postSprite;
     sf::Shader m_postShader;
 
+    void updateRows(const std::uint8_t*, std::uint32_t, std::uint32_t);
     void draw(sf::RenderTarget&, sf::RenderStates) const override;
 };
 
@@ -0,0 +1,61 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef SP_HEADLESS_HPP_
+#define SP_HEADLESS_HPP_
+
+#include <Board.hpp>
+#include <Mixer.hpp>
+#include <Recorder.hpp>
+#include <Options.hpp>
+
+#include <vector>
+
+/*!
+\brief Runs the board without a window or audio device,
+as fast as the host allows, optionally recording the output
+*/
+class Headless final
+{
+public:
+    explicit Headless(const Options&);
+    ~Headless() = default;
+    Headless(const Headless&) = delete;
+    Headless& operator = (const Headless&) = delete;
+
+    /*!
+    \brief Runs the number of frames given in the options
+    \returns Process exit code
+    */
+    int run();
+
+private:
+    Options m_options;
+    Board m_board;
+    Mixer m_mixer;
+    Recorder m_recorder;
+
+    std::vector<std::int16_t> m_audioBuffer;
+};
+
+#endif //SP_HEADLESS_HPP_
@@ -0,0 +1,83 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef SP_INPUT_POLLER_HPP_
+#define SP_INPUT_POLLER_HPP_
+
+#include <KeyBindings.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class InputState;
+
+/*!
+\brief Polls the keyboard on a dedicated thread at a high rate
+and publishes the state of the bound keys to an InputState, so
+the guest sees a press within a poll interval rather than
+waiting for the next pass of the window event loop.
+*/
+class InputPoller final
+{
+public:
+    explicit InputPoller(InputState&);
+    ~InputPoller();
+    InputPoller(const InputPoller&) = delete;
+    InputPoller& operator = (const InputPoller&) = delete;
+
+    /*!
+    \brief Starts the polling thread
+    \param rate Polls per second
+    */
+    void start(std::uint32_t rate = 1000u);
+    void stop();
+
+    /*!
+    \brief The keyboard is read regardless of window focus,
+    so polling should be disabled while the window isn't
+    focused. Disabling releases all the inputs.
+    */
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+
+    /*!
+    \brief Sets the keys polled, resolved against the input
+    map of the loaded machine
+    */
+    void setMappings(const std::vector<KeyBindings::Mapping>&);
+
+private:
+    InputState& m_inputState;
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_enabled;
+
+    std::mutex m_mutex;
+    std::vector<KeyBindings::Mapping> m_mappings;
+
+    void threadFunc(std::uint32_t);
+};
+
+#endif //SP_INPUT_POLLER_HPP_
\ No newline at end of file
@@ -0,0 +1,91 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef SP_INPUT_STATE_HPP_
+#define SP_INPUT_STATE_HPP_
+
+#include <I8080/I8080.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+/*!
+\brief The state of the cabinet's controls, published by
+whichever thread is reading the keyboard and read by the
+board at the moment the guest executes IN on a controls port.
+Ports 0 - 7 are packed one per byte into a single atomic so
+updates are lock free.
+*/
+class InputState final
+{
+public:
+    static constexpr std::size_t PortCount = 8u;
+
+    InputState() : m_bits(0) {}
+    ~InputState() = default;
+    InputState(const InputState&) = delete;
+    InputState& operator = (const InputState&) = delete;
+
+    /*!
+    \brief Sets or clears a single bit of a port
+    */
+    void set(std::size_t port, Byte bit, bool pressed)
+    {
+        if (port >= PortCount) return;
+
+        const auto mask = std::uint64_t(1) << (bit + getShift(port));
+        if (pressed)
+        {
+            m_bits.fetch_or(mask, std::memory_order_release);
+        }
+        else
+        {
+            m_bits.fetch_and(~mask, std::memory_order_release);
+        }
+    }
+
+    /*!
+    \brief Replaces the state of all ports at once, packed
+    with port 0 in the lowest byte
+    */
+    void store(std::uint64_t bits)
+    {
+        m_bits.store(bits, std::memory_order_release);
+    }
+
+    /*!
+    \brief Returns the current value of the given port
+    */
+    Byte read(std::size_t port) const
+    {
+        if (port >= PortCount) return 0;
+        return static_cast<Byte>(m_bits.load(std::memory_order_acquire) >> getShift(port));
+    }
+
+    static std::uint32_t getShift(std::size_t port) { return static_cast<std::uint32_t>(port * 8u); }
+
+private:
+    std::atomic<std::uint64_t> m_bits;
+};
+
+#endif //SP_INPUT_STATE_HPP_
\ No newline at end of file
@@ -0,0 +1,64 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef SP_KEY_BINDINGS_HPP_
+#define SP_KEY_BINDINGS_HPP_
+
+#include <SFML/Window/Keyboard.hpp>
+
+#include <array>
+#include <cstdint>
+
+//maps keys to the named inputs of the machine definitions,
+//shared by the window events and the input polling thread
+namespace KeyBindings
+{
+    struct Binding final
+    {
+        sf::Keyboard::Key key;
+        const char* input;
+    };
+
+    static const std::array<Binding, 9u> bindings =
+    {
+        Binding{ sf::Keyboard::Num0, "coin" },
+        Binding{ sf::Keyboard::Num1, "p1start" },
+        Binding{ sf::Keyboard::Num2, "p2start" },
+        Binding{ sf::Keyboard::Space, "p1fire" },
+        Binding{ sf::Keyboard::A, "p1left" },
+        Binding{ sf::Keyboard::D, "p1right" },
+        Binding{ sf::Keyboard::RControl, "p2fire" },
+        Binding{ sf::Keyboard::Left, "p2left" },
+        Binding{ sf::Keyboard::Right, "p2right" }
+    };
+
+    //a binding resolved to a port and bit of the loaded machine
+    struct Mapping final
+    {
+        sf::Keyboard::Key key;
+        std::size_t port;
+        std::uint8_t bit;
+    };
+}
+
+#endif //SP_KEY_BINDINGS_HPP_
\ No newline at end of file
@@ -0,0 +1,143 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef SP_LATENCY_TRACKER_HPP_
+#define SP_LATENCY_TRACKER_HPP_
+
+#include <I8080/I8080.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+/*!
+\brief Measures the latency of an input through the emulator.
+Each input event is timestamped on arrival, then tagged as it
+reaches each stage: the first guest IN whose value reflects the
+change, and the display() which presents the frame after it. The
+time taken by each stage is collected into histograms, and
+optionally logged to a CSV file.
+*/
+class LatencyTracker final
+{
+public:
+    enum Stage
+    {
+        InputToRead,
+        ReadToPresent,
+        Total,
+        StageCount
+    };
+
+    /*!
+    \brief Latencies in 1ms buckets up to BucketCount ms, with
+    longer latencies counted in the last bucket
+    */
+    class Histogram final
+    {
+    public:
+        static constexpr std::size_t BucketCount = 100u;
+
+        Histogram();
+
+        void add(float ms);
+        std::uint32_t getCount() const { return m_count; }
+        float getMean() const;
+        float getMax() const { return m_max; }
+        /*!
+        \brief Returns the upper bound of the bucket containing
+        the given percentile, in the range 0 - 1
+        */
+        float getPercentile(float) const;
+
+    private:
+        std::array<std::uint32_t, BucketCount> m_buckets;
+        std::uint32_t m_count;
+        double m_sum;
+        float m_max;
+    };
+
+    LatencyTracker();
+    ~LatencyTracker();
+    LatencyTracker(const LatencyTracker&) = delete;
+    LatencyTracker& operator = (const LatencyTracker&) = delete;
+
+    /*!
+    \brief Opens a CSV file to which each measurement is written
+    */
+    bool openLog(const std::string&);
+
+    /*!
+    \brief Call when an input event arrives, with the port and bit
+    it's mapped to and whether it was pressed or released. Ignored
+    if a measurement is already in progress.
+    */
+    void inputArrived(std::size_t port, Byte bit, bool pressed);
+    /*!
+    \brief Call when the guest reads an input port, with the value
+    it read. Only a read which sees the new state of the input
+    completes the first stage
+    */
+    void portRead(std::size_t port, Byte value);
+    /*!
+    \brief Call after the window has been displayed
+    */
+    void presented();
+
+    const Histogram& getHistogram(Stage stage) const { return m_histograms[stage]; }
+
+    /*!
+    \brief Returns a summary of the histograms suitable for display
+    */
+    std::string getSummary() const;
+
+    /*!
+    \brief Returns the number of completed measurements. Useful
+    for knowing when the summary has changed.
+    */
+    std::uint32_t getSampleCount() const { return m_histograms[Total].getCount(); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    enum class State
+    {
+        Idle,
+        WaitingForRead,
+        WaitingForPresent
+    }m_state;
+
+    std::size_t m_port;
+    Byte m_mask; //!< the bit of the port being measured
+    Byte m_expected; //!< the value of that bit once the input is seen
+    std::array<Clock::time_point, StageCount> m_timestamps; //!< input, read, present
+
+    std::array<Histogram, StageCount> m_histograms;
+    std::ofstream m_log;
+
+    void complete();
+};
+
+#endif //SP_LATENCY_TRACKER_HPP_
\ No newline at end of file
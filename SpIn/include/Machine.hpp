@@ -27,15 +27,28 @@ source distribution.
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/Text.hpp>
 #include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Sprite.hpp>
 
-#include <I8080/I8080.hpp>
+#include <Board.hpp>
+#include <InputState.hpp>
+#include <InputPoller.hpp>
 #include <Display.hpp>
-#include <SoundPlayer.hpp>
+#include <Mixer.hpp>
+#include <AudioStream.hpp>
+#include <Resampler.hpp>
+#include <Recorder.hpp>
+#include <Options.hpp>
+#include <LatencyTracker.hpp>
+#include <PerfHud.hpp>
+
+#include <string>
+#include <vector>
 
 class Machine final
 {
 public:
-    Machine();
+    explicit Machine(const Options&);
     ~Machine() = default;
     Machine(const Machine&) = delete;
     Machine& operator = (const Machine&) = delete;
@@ -43,37 +56,60 @@ public:
     void run();
 
 private:
+    Options m_options;
     sf::RenderWindow m_renderWindow;
 
-    I8080::CPU m_processor;
-
-    std::array<Byte, I8080::PORT_COUNT> m_ports;
+    Board m_board;
 
-    Word m_shiftValue;
-    Word m_shiftOffset;
+    InputState m_inputState;
+    InputPoller m_inputPoller;
+    std::vector<KeyBindings::Mapping> m_keyMappings;
 
-    sf::Text m_infoText;
+    PerfHud m_perfHud;
     sf::Font m_font;
 
     sf::Text m_instructionText;
 
     Display m_display;
-    SoundPlayer m_soundPlayer;
 
-    enum class Game
-    {
-        SpaceInvaders,
-        BalloonBomber,
-        LunarRescue
-    };
-    void loadGame(Game);
-
-    void update(float dt);
+    //sound is mixed in software each frame, then both
+    //streamed to the audio device and recorded
+    Mixer m_mixer;
+    AudioStream m_audioStream;
+    Recorder m_recorder;
+    std::vector<std::int16_t> m_audioBuffer;
+
+    Resampler m_resampler;
+    std::vector<std::int16_t> m_resampleBuffer;
+    double m_averageFill;
+
+    //fast forward skips presenting all but every Nth frame
+    bool m_turbo;
+    bool m_presenting;
+
+    Board::State m_runAheadState;
+    bool m_speculating;
+
+    LatencyTracker m_latencyTracker;
+    sf::Text m_latencyText;
+    bool m_showLatency;
+    std::uint32_t m_latencySampleCount;
+
+    //memory coverage drawn over the display
+    sf::Texture m_heatmapTexture;
+    sf::Sprite m_heatmapSprite;
+    std::vector<std::uint8_t> m_heatmapPixels;
+    bool m_showHeatmap;
+    std::uint32_t m_featuresBeforeHeatmap; //restored when the heatmap is hidden
+
+    void loadGame(const std::string&);
+
+    void update(bool present = true);
+    void updateRunAhead();
+    double getResampleRatio();
     void handleEvent(const sf::Event&);
+    void updateHeatmap();
     void draw();
-
-    void setFlag(std::size_t, Byte);
-    void unsetFlag(std::size_t, Byte);
 };
 
 #endif //SP_MACHINE_HPP_
\ No newline at end of file
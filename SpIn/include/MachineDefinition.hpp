@@ -0,0 +1,188 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+#ifndef SP_MACHINE_DEFINITION_HPP_
+#define SP_MACHINE_DEFINITION_HPP_
+
+#include <I8080/I8080.hpp>
+
+#include <Overlay.hpp>
+#include <Sounds.hpp>
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+/*!
+\brief Describes the hardware of a Midway 8080 title: the ROM
+chips, the devices wired to each I/O port, the cabinet's overlay,
+the input bit map and the interrupt schedule. Definitions are
+plain text, one entry per line, with # starting a comment:
+
+    name <display name>
+    rom <path> <address> [crc32]
+    in <port> <controls|shift-result>
+    out <port> <shift-data|shift-offset>
+    sound <port> <bit> <sound>
+    input <name> <port> <bit>
+    overlay <x> <y> <width> <height> <r> <g> <b>
+    interrupt <top|bottom> <cycle> <rst>
+
+Numbers may be given in hex with a 0x prefix, checksums are
+always hex. Each file is parsed once and compiled into fixed
+per port tables, so the Board only does lookups at run time.
+
+The schedule is limited to the two interrupts of the Midway
+boards: one top, and one bottom which ends the frame. The
+Board runs fixed 60Hz frames, so only loads definitions whose
+bottom interrupt is at cycle 33333 (Board::CyclesPerFrame).
+*/
+class MachineDefinition final
+{
+public:
+    /*!
+    \brief Device read by IN on a port
+    */
+    enum class InputDevice : std::uint8_t
+    {
+        None, //!< reads 0
+        Controls, //!< the cabinet's switches and buttons
+        ShiftResult //!< the shift register, shifted by its offset
+    };
+
+    /*!
+    \brief Device written by OUT to a port
+    */
+    enum class OutputDevice : std::uint8_t
+    {
+        None,
+        ShiftData, //!< shifts a byte in to the shift register
+        ShiftOffset, //!< sets the offset of the shift register
+        Sound //!< latches sound bits, which trigger when they change
+    };
+
+    struct Rom final
+    {
+        std::string path;
+        Word address = 0;
+        std::uint32_t checksum = 0;
+        bool hasChecksum = false;
+    };
+
+    struct Input final
+    {
+        std::string name;
+        std::size_t port = 0;
+        Byte bit = 0;
+    };
+
+    /*!
+    \brief An interrupt raised as the beam leaves a half
+    of the screen, at a cycle relative to the frame start
+    */
+    struct Interrupt final
+    {
+        std::int32_t cycle = 0;
+        Byte rst = 0;
+    };
+
+    /*!
+    \brief The top and bottom half interrupts, in scan order.
+    There are always exactly two
+    */
+    using Schedule = std::array<Interrupt, 2u>;
+
+    MachineDefinition();
+
+    /*!
+    \brief Parses a definition, replacing the current one
+    \returns false if the file couldn't be opened or contained
+    an invalid entry, in which case the definition is empty
+    */
+    bool loadFromFile(const std::string&);
+
+    /*!
+    \brief Parses a definition from the given stream
+    \param source Name of the stream used in error messages
+    */
+    bool loadFromStream(std::istream&, const std::string& source);
+
+    /*!
+    \brief Returns true if a definition was successfully loaded
+    */
+    bool isLoaded() const { return m_schedule[1].cycle > 0; }
+
+    /*!
+    \brief Returns the path of the definition for the given
+    game name, eg assets/machines/invaders.txt for invaders
+    */
+    static std::string getPath(const std::string& name);
+
+    const std::string& getName() const { return m_name; }
+    const std::vector<Rom>& getRoms() const { return m_roms; }
+    const std::vector<Input>& getInputs() const { return m_inputs; }
+    const std::vector<Overlay::Region>& getOverlay() const { return m_overlay; }
+    const Schedule& getSchedule() const { return m_schedule; }
+
+    /*!
+    \brief Returns the input with the given name, or
+    nullptr if the machine has no such input
+    */
+    const Input* findInput(const std::string&) const;
+
+    /*!
+    \brief Returns the device wired to the given port, ports
+    outside the board's range have nothing wired to them
+    */
+    InputDevice getInputDevice(Byte port) const
+    {
+        return (port < I8080::PORT_COUNT) ? m_inputDevices[port] : InputDevice::None;
+    }
+    OutputDevice getOutputDevice(Byte port) const
+    {
+        return (port < I8080::PORT_COUNT) ? m_outputDevices[port] : OutputDevice::None;
+    }
+
+    /*!
+    \brief Returns the ID of the sound triggered by the given
+    bit of a sound port, or -1 if the bit isn't wired to one.
+    The port must be one for which getOutputDevice() is Sound.
+    */
+    Sound::ID getSound(Byte port, Byte bit) const { return m_sounds[port][bit]; }
+
+private:
+    std::string m_name;
+    std::vector<Rom> m_roms;
+    std::vector<Input> m_inputs;
+    std::vector<Overlay::Region> m_overlay;
+    Schedule m_schedule;
+
+    std::array<InputDevice, I8080::PORT_COUNT> m_inputDevices;
+    std::array<OutputDevice, I8080::PORT_COUNT> m_outputDevices;
+    std::array<std::array<Sound::ID, 8u>, I8080::PORT_COUNT> m_sounds;
+
+    void clear();
+};
+
+#endif //SP_MACHINE_DEFINITION_HPP_
\ No newline at end of file
@@ -0,0 +1,129 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef SP_MIXER_HPP_
+#define SP_MIXER_HPP_
+
+#include <Sounds.hpp>
+#include <Synth.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/*!
+\brief Software mixer which renders the sound effects into
+blocks of 16 bit mono PCM, either by playing back samples or
+by synthesising the circuits of the sound board. Sounds are
+started and stopped by events placed at a sample offset within
+the next block, so the output is sample accurate to the emulated
+CPU. Doesn't require an audio device, so it can also produce the
+audio track of a recording headless.
+*/
+class Mixer final
+{
+public:
+    static constexpr std::uint32_t SampleRate = 44100u;
+    static constexpr std::size_t ChannelCount = 16u; //!< IDs must be less than this
+    static constexpr std::size_t MaxEvents = 64u; //!< per mixed block
+
+    enum class Source
+    {
+        Synth, //!< models the sound board circuits, requires no assets
+        Samples //!< plays the WAV files listed in Sounds.hpp
+    };
+
+    Mixer();
+    ~Mixer() = default;
+    Mixer(const Mixer&) = delete;
+    Mixer& operator = (const Mixer&) = delete;
+
+    /*!
+    \brief Loads the sample for each of the sound IDs
+    \returns false if none of the samples could be loaded
+    */
+    bool loadSamples();
+
+    /*!
+    \brief Sets whether sounds are synthesised or played from samples.
+    Samples must be loaded with loadSamples() before they can be played.
+    */
+    void setSource(Source source) { m_source = source; reset(); }
+    Source getSource() const { return m_source; }
+
+    /*!
+    \brief Starts or stops a sound.
+    One shot sounds restart when started and play to the end
+    regardless of being stopped. Looped sounds play until they
+    are stopped.
+    \param offset Number of samples into the next mixed
+    block at which the event happens. Events must be queued
+    in order.
+    */
+    void queueEvent(Sound::ID, bool start, std::uint32_t offset = 0u);
+
+    /*!
+    \brief Stops all sounds and discards any queued events
+    */
+    void reset();
+
+    /*!
+    \brief Mixes all the playing sounds into the given buffer,
+    applying any queued events as it goes
+    */
+    void mix(std::int16_t*, std::uint32_t);
+
+private:
+    struct Sample final
+    {
+        std::vector<std::int16_t> data;
+        bool loop = false;
+    };
+    std::array<Sample, ChannelCount> m_samples;
+
+    struct Voice final
+    {
+        bool playing = false;
+        std::size_t position = 0;
+    };
+    std::array<Voice, ChannelCount> m_voices;
+
+    struct Event final
+    {
+        Sound::ID id = 0;
+        bool start = false;
+        std::uint32_t offset = 0;
+    };
+    std::array<Event, MaxEvents> m_events;
+    std::size_t m_eventCount;
+
+    std::vector<std::int32_t> m_mixBuffer;
+
+    Source m_source;
+    Synth m_synth;
+
+    void applyEvent(const Event&);
+    void render(std::uint32_t, std::uint32_t);
+};
+
+#endif //SP_MIXER_HPP_
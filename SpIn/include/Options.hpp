@@ -0,0 +1,96 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef SP_OPTIONS_HPP_
+#define SP_OPTIONS_HPP_
+
+#include <Board.hpp>
+#include <Recorder.hpp>
+#include <Mixer.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*!
+\brief Settings parsed from the command line
+*/
+struct Options final
+{
+    enum class Pacing
+    {
+        Audio, //!< audio device clock, frames run as the stream drains with the audio resampled to hold its target fill
+        Clock //!< host clock only
+    };
+
+    bool showHelp = false;
+    bool headless = false; //!< run without a window or audio device, as fast as possible
+
+    bool hasGame = false; //!< load a game at start up rather than waiting for a key press
+    std::string game = "invaders"; //!< name of the definition in assets/machines
+
+    std::uint32_t frameCount = 3600u; //!< number of frames to run when headless
+
+    Mixer::Source soundSource = Mixer::Source::Synth;
+    Pacing pacing = Pacing::Audio;
+
+    std::uint32_t turboFrameSkip = 8u; //!< only every Nth frame is displayed when fast forwarding
+    bool turboAudio = false; //!< keep playing audio when fast forwarding, decimated to real time
+
+    bool inputThread = false; //!< poll the keyboard on a dedicated thread
+    bool highLevel = false; //!< run known ROM routines natively
+    bool fusion = true; //!< dispatch common runs of instructions as one
+    std::string opcodeStatsPath; //!< per opcode counts are collected and written here on exit if set
+    std::string sequenceStatsPath; //!< counts of instruction pairs and triples are collected and written here on exit if set
+    std::string callGraphPath; //!< folded call stacks are collected and written here on exit if set
+    std::string routineStatsPath; //!< per routine cycle totals are collected and written here on exit if set
+    std::string symbolsPath; //!< labels used to name guest routines when profiling
+    std::string instructionTracePath; //!< every executed instruction is written here if set
+    std::string coveragePath; //!< coverage of each ROM chip and RAM region is written here on exit if set
+    std::string heatmapPath; //!< an image of memory coverage is saved here on exit if set
+    std::vector<Word> breakpoints; //!< guest addresses at which the CPU is stopped
+    std::vector<I8080::Debugger::Watchpoint> watchpoints;
+    std::string tracePath = "trace.json"; //!< where the timeline is written when tracing is enabled
+    std::string latencyLogPath; //!< CSV of input latency measurements, not written if empty
+    std::uint32_t runAheadFrames = 0u; //!< frames emulated ahead of the displayed one to hide input lag
+
+    Recorder::Settings recording;
+
+    /*!
+    \brief Parses the given command line arguments
+    \returns false if any of the arguments were invalid
+    */
+    bool parse(int argc, char** argv);
+
+    /*!
+    \brief Returns the CPU Feature flags needed by these options
+    */
+    std::uint32_t getProcessorFeatures() const;
+
+    /*!
+    \brief Prints a description of the available options
+    */
+    static void printUsage();
+};
+
+#endif //SP_OPTIONS_HPP_
@@ -21,47 +21,28 @@ and must not be misrepresented as being the original software.
 source distribution.
 *********************************************************************/
 
-#ifndef SP_SOUNDPLAYER_HPP_
-#define SP_SOUNDPLAYER_HPP_
-
-#include <SFML/Audio/SoundBuffer.hpp>
-#include <SFML/Audio/Sound.hpp>
+#ifndef SP_OVERLAY_HPP_
+#define SP_OVERLAY_HPP_
 
 #include <cstdint>
-#include <map>
-#include <list>
 
-class SoundPlayer final
+//the original cabinet had strips of coloured gel stuck to
+//the monitor. Each machine definition lists its regions in
+//(unrotated) screen coordinates, and they're shared by the
+//GL and software renderers. Regions are applied in order,
+//so later regions are drawn over earlier ones
+namespace Overlay
 {
-public:
-    using ID = std::int32_t;
-
-    enum
+    struct Region final
     {
-        Shot = 2,
-        ShipHit = 3,
-        InvaderHit = 4,
-        ExtendedPlay = 5,
-
-        Invader0 = 10,
-        Invader1 = 11,
-        Invader2 = 12,
-        Invader3 = 13,
-        MotherShip = 14
+        std::uint16_t x;
+        std::uint16_t y;
+        std::uint16_t width;
+        std::uint16_t height;
+        std::uint8_t r;
+        std::uint8_t g;
+        std::uint8_t b;
     };
+}
 
-    SoundPlayer();
-    ~SoundPlayer() = default;
-    SoundPlayer(const SoundPlayer&) = delete;
-    SoundPlayer& operator = (const SoundPlayer&) = delete;
-
-    void update();
-    void play(ID);
-
-private:
-
-    std::map<ID, sf::SoundBuffer> m_soundBuffers;
-    std::list<sf::Sound> m_sounds;
-};
-
-#endif //SP_SOUNDPLAYER_HPP_
\ No newline at end of file
+#endif //SP_OVERLAY_HPP_
@@ -0,0 +1,101 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef SP_PERF_HUD_HPP_
+#define SP_PERF_HUD_HPP_
+
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Text.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+/*!
+\brief Overlay of performance counters: emulated clock speed,
+host frame time percentiles, instructions per frame, texture
+upload time and audio buffer fill. Values are accumulated
+cheaply as they happen and the text is only rebuilt, at most
+a few times a second, when the displayed values change.
+*/
+class PerfHud final : public sf::Drawable
+{
+public:
+    PerfHud();
+    ~PerfHud() = default;
+    PerfHud(const PerfHud&) = delete;
+    PerfHud& operator = (const PerfHud&) = delete;
+
+    void setFont(const sf::Font&);
+    void setPosition(float x, float y) { m_text.setPosition(x, y); }
+
+    void setVisible(bool visible) { m_visible = visible; }
+    bool isVisible() const { return m_visible; }
+
+    /*!
+    \brief Call after each emulated frame with the CPU's
+    running cycle and instruction counts
+    */
+    void addEmulatedFrame(std::uint64_t cycles, std::uint64_t instructions);
+
+    /*!
+    \brief Adds to the time spent converting and uploading VRAM
+    */
+    void addUploadTime(std::chrono::steady_clock::duration);
+
+    /*!
+    \brief Call once per host frame, after display()
+    \param audioFill Number of samples queued for the audio device
+    */
+    void update(std::size_t audioFill);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    sf::Text m_text;
+    bool m_visible;
+
+    Clock::time_point m_lastFrame;
+    Clock::time_point m_lastRefresh;
+
+    std::array<float, 128u> m_frameTimes; //!< ms, ring of the most recent host frames
+    std::size_t m_frameTimeCount;
+
+    std::uint64_t m_firstCycles;
+    std::uint64_t m_lastCycles;
+    std::uint64_t m_firstInstructions;
+    std::uint64_t m_lastInstructions;
+    std::uint32_t m_emulatedFrames;
+    bool m_hasCounts;
+
+    Clock::duration m_uploadTime;
+    std::uint32_t m_uploadCount;
+
+    std::array<char, 256u> m_string;
+
+    void refresh(Clock::time_point, std::size_t);
+
+    void draw(sf::RenderTarget&, sf::RenderStates) const override;
+};
+
+#endif //SP_PERF_HUD_HPP_
\ No newline at end of file
@@ -0,0 +1,140 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef SP_RECORDER_HPP_
+#define SP_RECORDER_HPP_
+
+#include <I8080/I8080.hpp>
+
+#include <Overlay.hpp>
+
+namespace sf
+{
+    class OutputSoundFile;
+}
+class Compositor;
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*!
+\brief Captures emulated frames and audio to disk. Frames are
+copied into a bounded queue of preallocated slots and written
+out on a background thread, so the emulation loop never waits
+on the disk unless lossless recording is requested.
+*/
+class Recorder final
+{
+public:
+    enum class VideoFormat
+    {
+        Raw, //!< header followed by each frame of VRAM, packed 8 pixels per byte
+        Y4M //!< composited output as uncompressed YUV4MPEG2 (4:4:4)
+    };
+
+    struct Settings final
+    {
+        std::string videoPath; //!< no video is written if this is empty
+        VideoFormat videoFormat = VideoFormat::Y4M;
+        std::uint32_t videoScale = 1u; //!< scale of composited output
+        std::vector<Overlay::Region> overlay; //!< overlay of the game being recorded
+        std::string audioPath; //!< 16 bit mono WAV. No audio is written if empty
+        bool lossless = false; //!< block when the queue is full rather than drop video frames
+    };
+
+    Recorder();
+    ~Recorder();
+    Recorder(const Recorder&) = delete;
+    Recorder& operator = (const Recorder&) = delete;
+
+    /*!
+    \brief Opens the output files and starts the writer thread
+    \returns false if there's nothing to record or the files couldn't be opened
+    */
+    bool start(const Settings&);
+
+    /*!
+    \brief Flushes any queued frames and closes the output files
+    */
+    void stop();
+
+    bool isRecording() const { return m_recording; }
+
+    /*!
+    \brief Queues a frame of VRAM along with the audio samples
+    produced during that frame
+    */
+    void pushFrame(const Byte* vram, const std::int16_t* samples, std::uint32_t sampleCount);
+
+    /*!
+    \brief Number of video frames which were dropped because the queue
+    was full. Each is replaced with a copy of the frame before it, and
+    its audio is still written, so the recording stays in sync
+    */
+    std::uint64_t getDroppedFrameCount() const { return m_droppedFrames; }
+
+private:
+    struct Frame final
+    {
+        std::array<Byte, I8080::VRAM_SIZE> vram;
+        std::vector<std::int16_t> samples;
+        std::uint32_t sampleCount = 0;
+        std::uint32_t repeats = 0; //times the video is written again, for dropped frames
+    };
+    std::vector<Frame> m_frames;
+    std::size_t m_readIndex;
+    std::size_t m_writeIndex;
+    std::size_t m_queuedCount;
+
+    std::mutex m_mutex;
+    std::condition_variable m_frameQueued;
+    std::condition_variable m_frameWritten;
+
+    Settings m_settings;
+    bool m_recording;
+    bool m_stopping;
+    std::atomic<std::uint64_t> m_droppedFrames;
+    std::thread m_thread;
+
+    //only touched by the writer thread while recording
+    std::ofstream m_videoFile;
+    std::unique_ptr<sf::OutputSoundFile> m_audioFile;
+    std::unique_ptr<Compositor> m_compositor;
+    std::vector<std::uint8_t> m_videoBuffer;
+    std::uint64_t m_writtenFrames;
+
+    void threadFunc();
+    void appendSamples(Frame&, const std::int16_t*, std::uint32_t);
+    void writeFrame(const Frame&);
+    void writeVideo(const Frame&);
+};
+
+#endif //SP_RECORDER_HPP_
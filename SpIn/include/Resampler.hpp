@@ -0,0 +1,58 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef SP_RESAMPLER_HPP_
+#define SP_RESAMPLER_HPP_
+
+#include <cstdint>
+
+/*!
+\brief Stretches a stream of mono samples by a ratio close
+to 1 using linear interpolation. State carries over between
+calls so consecutive blocks join without clicks.
+*/
+class Resampler final
+{
+public:
+    Resampler();
+    ~Resampler() = default;
+    Resampler(const Resampler&) = delete;
+    Resampler& operator = (const Resampler&) = delete;
+
+    /*!
+    \brief Resamples a block of input
+    \param ratio Number of output samples per input sample
+    \returns The number of samples written to output, which
+    never exceeds maxOutput
+    */
+    std::uint32_t process(const std::int16_t* input, std::uint32_t inputCount,
+                            std::int16_t* output, std::uint32_t maxOutput, double ratio);
+
+    void reset();
+
+private:
+    double m_position; //!< in input samples, relative to m_previous
+    std::int16_t m_previous;
+};
+
+#endif //SP_RESAMPLER_HPP_
\ No newline at end of file
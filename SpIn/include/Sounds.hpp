@@ -0,0 +1,75 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef SP_SOUNDS_HPP_
+#define SP_SOUNDS_HPP_
+
+#include <array>
+#include <cstdint>
+
+//IDs of the sound effects triggered by the bits of the sound
+//ports, along with the sample used for each. Which bit triggers
+//which sound is wired up by name in each machine definition
+namespace Sound
+{
+    using ID = std::int32_t;
+
+    enum
+    {
+        UFO = 0,
+        Shot = 1,
+        ShipHit = 2,
+        InvaderHit = 3,
+        ExtendedPlay = 4,
+
+        Invader0 = 10,
+        Invader1 = 11,
+        Invader2 = 12,
+        Invader3 = 13,
+        MotherShip = 14
+    };
+
+    struct File final
+    {
+        ID id;
+        const char* name; //!< used by machine definitions
+        const char* path;
+        bool loop; //!< plays for as long as the bit is set
+    };
+
+    static const std::array<File, 10u> files =
+    {
+        File{ UFO, "ufo", "assets/sounds/ufo.wav", true },
+        File{ Shot, "shot", "assets/sounds/shot.wav", false },
+        File{ ShipHit, "shiphit", "assets/sounds/ship_hit.wav", false },
+        File{ InvaderHit, "invaderhit", "assets/sounds/invader_hit.wav", false },
+        File{ ExtendedPlay, "extendedplay", "assets/sounds/extended_play.wav", false },
+        File{ Invader0, "invader0", "assets/sounds/inv01.wav", false },
+        File{ Invader1, "invader1", "assets/sounds/inv02.wav", false },
+        File{ Invader2, "invader2", "assets/sounds/inv03.wav", false },
+        File{ Invader3, "invader3", "assets/sounds/inv04.wav", false },
+        File{ MotherShip, "mothership", "assets/sounds/mothership_hit.wav", false }
+    };
+}
+
+#endif //SP_SOUNDS_HPP_
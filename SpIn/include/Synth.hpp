@@ -0,0 +1,122 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef SP_SYNTH_HPP_
+#define SP_SYNTH_HPP_
+
+#include <Sounds.hpp>
+
+#include <array>
+#include <cstdint>
+
+/*!
+\brief Synthesises the sound effects by modelling the discrete
+circuits of the Midway sound board. Each circuit is the same
+small network with its own component values: a 555 style VCO
+whose control voltage is modulated by a triangle LFO and by a
+discharging sweep capacitor, mixed with the shared noise source,
+through a state variable filter whose cutoff follows the sweep,
+then AC coupled and shaped by an RC envelope. Each circuit is
+one lane of a set of structure of arrays, processed four lanes
+at a time with SSE where available, in blocks of BlockSize.
+*/
+class Synth final
+{
+public:
+    static constexpr std::size_t LaneCount = 8u;
+    static constexpr std::uint32_t BlockSize = 64u;
+
+    explicit Synth(std::uint32_t sampleRate);
+    ~Synth() = default;
+    Synth(const Synth&) = delete;
+    Synth& operator = (const Synth&) = delete;
+
+    /*!
+    \brief Sets the state of the port bit for the given sound
+    */
+    void setGate(Sound::ID, bool);
+
+    /*!
+    \brief Silences all circuits
+    */
+    void reset();
+
+    /*!
+    \brief Renders the given number of samples, adding them
+    to the output at 16 bit scale
+    */
+    void render(std::int32_t*, std::uint32_t);
+
+private:
+    using Lane = std::array<float, LaneCount>;
+
+    //fixed properties of each circuit, as per sample coefficients
+    struct Parameters final
+    {
+        alignas(16) Lane duty = {}; //!< fraction of each VCO cycle spent high
+        alignas(16) Lane lfoFrequency = {}; //!< triangle cycles per sample
+        alignas(16) Lane lfoDepth = {}; //!< VCO frequency deviation at the LFO peaks
+        alignas(16) Lane sweepDecay = {}; //!< sweep capacitor multiplier per sample
+        alignas(16) Lane sweepDepth = {}; //!< VCO frequency deviation of a charged sweep capacitor
+        alignas(16) Lane tone = {}; //!< VCO level
+        alignas(16) Lane noise = {}; //!< noise level
+        alignas(16) Lane cutoff = {}; //!< filter frequency coefficient
+        alignas(16) Lane cutoffSweep = {}; //!< added to the cutoff by a charged sweep capacitor
+        alignas(16) Lane damping = {}; //!< inverse of the filter's Q
+        alignas(16) Lane lowPass = {}; //!< level of the filter's low pass output
+        alignas(16) Lane bandPass = {}; //!< level of the filter's band pass output
+        alignas(16) Lane coupling = {}; //!< AC coupling high pass coefficient
+        alignas(16) Lane attack = {};
+        alignas(16) Lane release = {}; //!< envelope multiplier per sample
+        alignas(16) Lane gain = {};
+    };
+    Parameters m_parameters;
+
+    //running state of each circuit
+    struct State final
+    {
+        alignas(16) Lane gate = {}; //!< 1 while held
+        alignas(16) Lane envelope = {};
+        alignas(16) Lane frequency = {}; //!< VCO cycles per sample with no modulation
+        alignas(16) Lane phase = {};
+        alignas(16) Lane lfoPhase = {};
+        alignas(16) Lane sweep = {}; //!< charge of the sweep capacitor, 0 - 1
+        alignas(16) Lane low = {};
+        alignas(16) Lane band = {};
+        alignas(16) Lane dc = {}; //!< level removed by the coupling capacitor
+    };
+    State m_state;
+
+    alignas(16) Lane m_frequencies; //!< VCO cycles per sample of each circuit when triggered
+    std::array<bool, LaneCount> m_held; //!< follows the port bit, else triggers a one shot
+    std::array<float, 4u> m_fleetFrequencies;
+    float m_sampleRate;
+    std::uint32_t m_noiseState;
+    alignas(16) std::array<float, BlockSize> m_noise;
+
+    void renderLanes(std::size_t first, std::uint32_t count, float* mixed);
+    void trigger(std::size_t lane, float frequency);
+    bool isActive() const;
+};
+
+#endif //SP_SYNTH_HPP_
\ No newline at end of file
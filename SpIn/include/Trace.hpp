@@ -0,0 +1,88 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef SP_TRACE_HPP_
+#define SP_TRACE_HPP_
+
+#include <cstdint>
+#include <string>
+
+/*!
+Lightweight timeline tracing. Scoped spans and instant events
+are recorded into a lock free ring buffer owned by the thread
+which records them, and can be dumped at any time as JSON for
+chrome://tracing or Perfetto. Define SPIN_TRACING to enable the
+macros, otherwise they compile to nothing.
+*/
+namespace Trace
+{
+    /*!
+    \brief Records a complete event. Name must be a string literal
+    */
+    void span(const char* name, std::uint64_t start, std::uint64_t end);
+
+    /*!
+    \brief Records an instant event with an optional value
+    */
+    void instant(const char* name, std::int32_t value = 0);
+
+    /*!
+    \brief Returns the time since tracing started in nanoseconds
+    */
+    std::uint64_t now();
+
+    /*!
+    \brief Writes the events currently held by every thread's
+    ring buffer to a JSON file
+    \returns false if tracing is disabled or the file couldn't be written
+    */
+    bool dump(const std::string& path);
+
+    /*!
+    \brief Records a span from construction to destruction
+    */
+    class Scope final
+    {
+    public:
+        explicit Scope(const char* name) : m_name(name), m_start(now()) {}
+        ~Scope() { span(m_name, m_start, now()); }
+        Scope(const Scope&) = delete;
+        Scope& operator = (const Scope&) = delete;
+
+    private:
+        const char* m_name;
+        std::uint64_t m_start;
+    };
+}
+
+#ifdef SPIN_TRACING
+#define SPIN_TRACE_CONCAT_(a, b) a##b
+#define SPIN_TRACE_CONCAT(a, b) SPIN_TRACE_CONCAT_(a, b)
+#define SPIN_TRACE_SCOPE(name) Trace::Scope SPIN_TRACE_CONCAT(traceScope, __LINE__)(name)
+#define SPIN_TRACE_INSTANT(name, value) Trace::instant(name, value)
+#else
+#define SPIN_TRACE_SCOPE(name)
+#define SPIN_TRACE_INSTANT(name, value)
+#endif //SPIN_TRACING
+
+#endif //SP_TRACE_HPP_
\ No newline at end of file
@@ -0,0 +1,103 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <AudioStream.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+constexpr std::size_t AudioStream::Capacity;
+constexpr std::size_t AudioStream::ChunkSize;
+
+namespace
+{
+    static_assert((AudioStream::Capacity & (AudioStream::Capacity - 1)) == 0, "Capacity must be a power of 2");
+    const std::size_t mask = AudioStream::Capacity - 1;
+}
+
+AudioStream::AudioStream(std::uint32_t sampleRate)
+    : m_buffer      (Capacity),
+    m_chunk         (ChunkSize),
+    m_readPosition  (0),
+    m_writePosition (0),
+    m_underrunCount (0)
+{
+    initialize(1, sampleRate);
+}
+
+AudioStream::~AudioStream()
+{
+    //the stream thread calls onGetData() so must
+    //be stopped before this is destroyed
+    stop();
+}
+
+//public
+std::size_t AudioStream::push(const std::int16_t* samples, std::size_t count)
+{
+    const auto write = m_writePosition.load(std::memory_order_relaxed);
+    const auto read = m_readPosition.load(std::memory_order_acquire);
+
+    count = std::min(count, Capacity - (write - read));
+
+    //copy in up to two parts where the ring wraps
+    const auto start = write & mask;
+    const auto first = std::min(count, Capacity - start);
+    std::memcpy(&m_buffer[start], samples, first * sizeof(std::int16_t));
+    std::memcpy(m_buffer.data(), samples + first, (count - first) * sizeof(std::int16_t));
+
+    m_writePosition.store(write + count, std::memory_order_release);
+    return count;
+}
+
+std::size_t AudioStream::getQueuedCount() const
+{
+    return m_writePosition.load(std::memory_order_acquire) - m_readPosition.load(std::memory_order_acquire);
+}
+
+//private
+bool AudioStream::onGetData(Chunk& chunk)
+{
+    const auto read = m_readPosition.load(std::memory_order_relaxed);
+    const auto write = m_writePosition.load(std::memory_order_acquire);
+
+    const auto count = std::min(ChunkSize, write - read);
+    const auto start = read & mask;
+    const auto first = std::min(count, Capacity - start);
+    std::memcpy(m_chunk.data(), &m_buffer[start], first * sizeof(std::int16_t));
+    std::memcpy(m_chunk.data() + first, m_buffer.data(), (count - first) * sizeof(std::int16_t));
+
+    m_readPosition.store(read + count, std::memory_order_release);
+
+    if (count < ChunkSize)
+    {
+        std::fill(m_chunk.begin() + count, m_chunk.end(), 0);
+        m_underrunCount++;
+    }
+
+    chunk.samples = m_chunk.data();
+    chunk.sampleCount = ChunkSize;
+
+    //returning false would stop the stream
+    return true;
+}
\ No newline at end of file
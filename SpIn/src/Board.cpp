@@ -0,0 +1,300 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <Board.hpp>
+#include <InputState.hpp>
+#include <Trace.hpp>
+
+#include <I8080/Crc32.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+
+constexpr std::int32_t Board::CyclesPerFrame;
+constexpr std::int32_t Board::FramesPerSecond;
+
+Board::Board()
+    : m_shiftValue      (0),
+    m_shiftOffset       (0),
+    m_frameCount        (0),
+    m_frameStartCycle   (0),
+    m_half              (Half::Top),
+    m_halfCycles        (0),
+    m_inputState        (nullptr)
+{
+    //each port switches on the device the definition wires to
+    //it, unwired ports read as 0 and ignore writes
+    I8080::CPU::InputHandler ih = [this](Byte port)->Byte
+    {
+        switch (m_definition.getInputDevice(port))
+        {
+        default: return 0;
+        case MachineDefinition::InputDevice::Controls:
+        {
+            const auto value = readInput(port);
+            if (m_portReadHandler)
+            {
+                m_portReadHandler(port, value);
+            }
+            return value;
+        }
+        case MachineDefinition::InputDevice::ShiftResult:
+            return static_cast<Byte>(((m_shiftValue << m_shiftOffset) & 0xFF));
+        }
+    };
+    m_processor.setInputHandler(ih);
+
+    I8080::CPU::OutputHandler oh = [this](Byte port, Byte value)
+    {
+        switch (m_definition.getOutputDevice(port))
+        {
+        default: break;
+        case MachineDefinition::OutputDevice::ShiftOffset:
+            m_shiftOffset = value;
+            break;
+        case MachineDefinition::OutputDevice::ShiftData:
+            m_shiftValue = (m_shiftValue << 8) | value;
+            break;
+        case MachineDefinition::OutputDevice::Sound:
+            updateSound(port, value);
+            break;
+        }
+    };
+    m_processor.setOutputHandler(oh);
+    std::memset(m_ports.data(), 0, I8080::PORT_COUNT);
+}
+
+//public
+bool Board::loadGame(const std::string& name)
+{
+    m_romChips.clear();
+    m_processor.getCoverage().clear();
+
+    bool loaded = m_definition.loadFromFile(MachineDefinition::getPath(name));
+    if (loaded && (m_definition.getRoms().empty() || m_definition.getSchedule()[1].cycle != CyclesPerFrame))
+    {
+        std::cout << name << ": needs at least one ROM and a bottom interrupt at cycle " << CyclesPerFrame << std::endl;
+        loaded = false;
+    }
+
+    const auto& roms = m_definition.getRoms();
+    for (auto i = 0u; i < roms.size() && loaded; ++i)
+    {
+        loaded = loadChip(roms[i], i == 0);
+    }
+
+    //a machine missing any of its ROMs isn't run at all
+    if (!loaded)
+    {
+        m_definition = MachineDefinition();
+        m_romChips.clear();
+    }
+
+    m_frameCount = 0;
+    m_frameStartCycle = 0;
+    m_half = Half::Top;
+    m_halfCycles = 0;
+
+    return loaded;
+}
+
+bool Board::update()
+{
+    //nothing is wired up until a game is loaded
+    if (!m_definition.isLoaded()) return true;
+
+    const auto& schedule = m_definition.getSchedule();
+    if (m_halfCycles <= 0)
+    {
+        m_frameStartCycle = m_processor.getCycleCount();
+        m_half = Half::Top;
+        m_halfCycles = schedule[0].cycle;
+    }
+
+    //the ROM redraws the top half of the screen after the
+    //mid-screen interrupt and the bottom half after VBLANK,
+    //so each half is captured as the beam leaves it when
+    //it's guaranteed not to be mid-update
+    if (m_half == Half::Top)
+    {
+        {
+            SPIN_TRACE_SCOPE("Top half");
+            if (!updateHalf()) return false;
+        }
+        if (m_rasterHandler)
+        {
+            m_rasterHandler(getVRAM(), Half::Top);
+        }
+        {
+            SPIN_TRACE_SCOPE("Mid-screen interrupt");
+            m_processor.raiseInterrupt(schedule[0].rst);
+        }
+
+        m_half = Half::Bottom;
+        m_halfCycles = schedule[1].cycle - schedule[0].cycle;
+    }
+
+    {
+        SPIN_TRACE_SCOPE("Bottom half");
+        if (!updateHalf()) return false;
+    }
+    if (m_rasterHandler)
+    {
+        m_rasterHandler(getVRAM(), Half::Bottom);
+    }
+    {
+        SPIN_TRACE_SCOPE("VBLANK interrupt");
+        m_processor.raiseInterrupt(schedule[1].rst);
+    }
+
+    m_halfCycles = 0;
+    m_frameCount++;
+    return true;
+}
+
+void Board::setDefinition(const MachineDefinition& definition)
+{
+    m_definition = definition;
+}
+
+void Board::setFlag(std::size_t port, Byte flag)
+{
+    assert(flag < 8);
+    m_ports[port] |= (1 << flag);
+}
+
+void Board::unsetFlag(std::size_t port, Byte flag)
+{
+    assert(flag < 8);
+    m_ports[port] &= ~(1 << flag);
+}
+
+void Board::saveState(State& state) const
+{
+    m_processor.saveState(state.processor);
+    state.ports = m_ports;
+    state.shiftValue = m_shiftValue;
+    state.shiftOffset = m_shiftOffset;
+    state.frameCount = m_frameCount;
+    state.frameStartCycle = m_frameStartCycle;
+    state.half = m_half;
+    state.halfCycles = m_halfCycles;
+}
+
+void Board::loadState(const State& state)
+{
+    m_processor.loadState(state.processor);
+    m_ports = state.ports;
+    m_shiftValue = state.shiftValue;
+    m_shiftOffset = state.shiftOffset;
+    m_frameCount = state.frameCount;
+    m_frameStartCycle = state.frameStartCycle;
+    m_half = state.half;
+    m_halfCycles = state.halfCycles;
+}
+
+float Board::getFramePosition(std::uint64_t cycle) const
+{
+    if (cycle <= m_frameStartCycle) return 0.f;
+
+    float position = static_cast<float>(cycle - m_frameStartCycle) / CyclesPerFrame;
+    return (position > 1.f) ? 1.f : position;
+}
+
+//private
+Byte Board::readInput(std::size_t port) const
+{
+    //controls are sampled as the guest reads them
+    //rather than once before the frame
+    return (m_inputState) ? m_ports[port] | m_inputState->read(port) : m_ports[port];
+}
+
+bool Board::loadChip(const MachineDefinition::Rom& rom, bool reset)
+{
+    //the image is read once, then checksummed and mapped from memory
+    std::ifstream file(rom.path, std::ios::in | std::ios::binary);
+    if (!file.good())
+    {
+        if (reset) m_processor.reset();
+        std::cout << "Failed opening file " << rom.path << std::endl;
+        return false;
+    }
+    const std::vector<Byte> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (!m_processor.loadROM(data, rom.address, reset))
+    {
+        std::cout << "Invalid file size... " << rom.path << std::endl;
+        return false;
+    }
+
+    //other dumps of a chip may still work, so a mismatch is only a warning
+    const auto checksum = I8080::crc32(data.data(), data.size());
+    if (rom.hasChecksum && checksum != rom.checksum)
+    {
+        std::cout << "Warning: " << rom.path << " has checksum " << std::hex << std::setfill('0')
+            << std::setw(8) << checksum << ", expected " << std::setw(8) << rom.checksum
+            << std::dec << std::setfill(' ') << std::endl;
+    }
+
+    RomChip chip;
+    chip.path = rom.path;
+    chip.address = rom.address;
+    chip.size = static_cast<Word>(data.size());
+    m_romChips.push_back(chip);
+    return true;
+}
+
+bool Board::updateHalf()
+{
+    m_halfCycles -= m_processor.update(m_halfCycles);
+
+    //if the debugger stopped the CPU part way through
+    //the remaining cycles are run on the next update
+    return !(m_halfCycles > 0 && m_processor.getDebugger().isStopped());
+}
+
+void Board::updateSound(std::size_t port, Byte value)
+{
+    //get bits which changed
+    auto changed = m_ports[port] ^ value;
+    if (changed && m_soundHandler)
+    {
+        const auto cycle = m_processor.getCycleCount();
+        for (auto i = 0; i < 8; ++i)
+        {
+            const auto id = m_definition.getSound(static_cast<Byte>(port), static_cast<Byte>(i));
+            if ((changed & (1 << i)) && id >= 0)
+            {
+                //sound started or stopped
+                SPIN_TRACE_INSTANT((value & (1 << i)) ? "Sound on" : "Sound off", id);
+                m_soundHandler(id, (value & (1 << i)) != 0, cycle);
+            }
+        }
+    }
+
+    m_ports[port] = value;
+}
\ No newline at end of file
@@ -0,0 +1,453 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <Compositor.hpp>
+
+#include <SFML/Graphics/Image.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPIN_COMPOSITOR_SSE
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    //source (unrotated) resolution
+    const std::uint32_t sourceWidth = 256u;
+    const std::uint32_t sourceHeight = 224u;
+
+    //these match the values in Display's blend
+    //shader and the PostChromeAb shader
+    const float backgroundStrength = 1.4f;
+    const float baseAlpha = 0.5f;
+    const float lineCount = 6000.f;
+    const float noiseStrength = 0.7f;
+    const float maxOffset = 1.f / 450.f;
+    const float centreDistanceSquared = 0.25f;
+
+    //GLSL mod() rounds towards negative infinity
+    inline float glslMod(float x, float y)
+    {
+        return x - y * std::floor(x / y);
+    }
+
+    inline std::uint8_t toByte(float v)
+    {
+        return static_cast<std::uint8_t>(std::min(std::max(v, 0.f), 1.f) * 255.f + 0.5f);
+    }
+
+    //film grain, from a seed which changes over time
+    inline float grainValue(float n)
+    {
+        n = glslMod(n, 13.f) * glslMod(n, 123.f);
+        return std::min(std::max((glslMod(n, 0.01f) - 0.005f) * 100.f, 0.f), 0.07f);
+    }
+
+    //applies the grain and scanlines to one pixel of already sampled colour
+    inline void postPixel(std::uint8_t* dst, float grain, float lineSin, float lineCos)
+    {
+        const float lineStrength = noiseStrength * 0.08f;
+        const float r = dst[0] / 255.f;
+        const float g = dst[1] / 255.f;
+        const float b = dst[2] / 255.f;
+
+        const float resultR = r + grain + r * lineSin * lineStrength;
+        const float resultG = g + grain + g * lineCos * lineStrength;
+        const float resultB = b + grain + b * lineSin * lineStrength;
+
+        dst[0] = toByte(r + (resultR - r) * noiseStrength);
+        dst[1] = toByte(g + (resultG - g) * noiseStrength);
+        dst[2] = toByte(b + (resultB - b) * noiseStrength);
+    }
+
+#ifdef SPIN_COMPOSITOR_SSE
+    //SSE2 has no floor instruction, so truncate and correct negative
+    //fractions. Exact while |x| fits in an int, which the seeds do
+    inline __m128 floorQuad(__m128 x)
+    {
+        const auto truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+        return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, x), _mm_set1_ps(1.f)));
+    }
+
+    inline __m128 glslModQuad(__m128 x, float y)
+    {
+        const auto divisor = _mm_set1_ps(y);
+        return _mm_sub_ps(x, _mm_mul_ps(divisor, floorQuad(_mm_div_ps(x, divisor))));
+    }
+
+    inline __m128 grainQuad(__m128 n)
+    {
+        n = _mm_mul_ps(glslModQuad(n, 13.f), glslModQuad(n, 123.f));
+        const auto grain = _mm_mul_ps(_mm_sub_ps(glslModQuad(n, 0.01f), _mm_set1_ps(0.005f)), _mm_set1_ps(100.f));
+        return _mm_min_ps(_mm_max_ps(grain, _mm_setzero_ps()), _mm_set1_ps(0.07f));
+    }
+
+    //the same arithmetic as postPixel(), in the same order, so both
+    //paths produce identical bytes
+    inline __m128i postChannel(__m128 colour, __m128 grain, __m128 line)
+    {
+        const auto lineStrength = _mm_set1_ps(noiseStrength * 0.08f);
+        const auto c = _mm_div_ps(colour, _mm_set1_ps(255.f));
+        const auto result = _mm_add_ps(_mm_add_ps(c, grain), _mm_mul_ps(_mm_mul_ps(c, line), lineStrength));
+        auto v = _mm_add_ps(c, _mm_mul_ps(_mm_sub_ps(result, c), _mm_set1_ps(noiseStrength)));
+        v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.f));
+        return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(255.f)), _mm_set1_ps(0.5f)));
+    }
+#endif //SPIN_COMPOSITOR_SSE
+
+    inline std::uint32_t packColour(float r, float g, float b, float a)
+    {
+        std::uint32_t colour = 0;
+        auto* bytes = reinterpret_cast<std::uint8_t*>(&colour);
+        bytes[0] = toByte(r);
+        bytes[1] = toByte(g);
+        bytes[2] = toByte(b);
+        bytes[3] = toByte(a);
+        return colour;
+    }
+
+    //nearest neighbour lookup with clamped edges, using the shader's
+    //texture coordinates. Render textures are flipped so y runs upwards
+    inline std::uint32_t sampleIndex(float u, float v)
+    {
+        auto x = static_cast<std::int32_t>(std::floor(u * sourceWidth));
+        auto y = static_cast<std::int32_t>(std::floor((1.f - v) * sourceHeight));
+        x = std::min(std::max(x, 0), static_cast<std::int32_t>(sourceWidth) - 1);
+        y = std::min(std::max(y, 0), static_cast<std::int32_t>(sourceHeight) - 1);
+        return static_cast<std::uint32_t>(y) * sourceWidth + x;
+    }
+}
+
+Compositor::Compositor(const std::vector<Overlay::Region>& overlay, std::uint32_t scale, std::uint32_t threadCount)
+    : m_width       (sourceHeight * std::max(scale, 1u)),
+    m_height        (sourceWidth * std::max(scale, 1u)),
+    m_generation    (0),
+    m_pendingCount  (0),
+    m_running       (true),
+    m_stage         (Stage::Blend),
+    m_vram          (nullptr),
+    m_time          (0.f)
+{
+    buildBlendTables(overlay);
+    buildPostTables(std::max(scale, 1u));
+    m_output.resize(m_width * m_height * 4u, 255u);
+
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    //the calling thread processes the first band itself
+    for (auto i = 1u; i < threadCount; ++i)
+    {
+        m_threads.emplace_back(&Compositor::threadFunc, this, i);
+    }
+}
+
+Compositor::~Compositor()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_startCondition.notify_all();
+
+    for (auto& t : m_threads)
+    {
+        t.join();
+    }
+}
+
+//public
+const std::uint8_t* Compositor::update(const std::uint8_t* vram, float time)
+{
+    m_vram = vram;
+    m_time = time;
+    runStage(Stage::Blend);
+    runStage(Stage::Post);
+
+    return m_output.data();
+}
+
+//private
+void Compositor::buildBlendTables(const std::vector<Overlay::Region>& regions)
+{
+    const auto pixelCount = sourceWidth * sourceHeight;
+    m_litColours.resize(pixelCount);
+    m_unlitColours.resize(pixelCount);
+    m_blended.resize(pixelCount);
+
+    std::vector<std::uint32_t> overlay(pixelCount, 0xFFFFFFFF);
+    for (const auto& region : regions)
+    {
+        std::uint32_t colour = 0;
+        auto* bytes = reinterpret_cast<std::uint8_t*>(&colour);
+        bytes[0] = region.r;
+        bytes[1] = region.g;
+        bytes[2] = region.b;
+        bytes[3] = 255u;
+
+        for (auto y = region.y; y < region.y + region.height; ++y)
+        {
+            std::fill_n(overlay.begin() + (y * sourceWidth + region.x), region.width, colour);
+        }
+    }
+
+    sf::Image background;
+    if (!background.loadFromFile("assets/images/background.png"))
+    {
+        background.create(1, 1, sf::Color::Black);
+    }
+    const auto bgSize = background.getSize();
+
+    for (auto y = 0u; y < sourceHeight; ++y)
+    {
+        for (auto x = 0u; x < sourceWidth; ++x)
+        {
+            //background is sampled with the same normalised coords as the base texture
+            const auto bgX = std::min(static_cast<std::uint32_t>((x + 0.5f) / sourceWidth * bgSize.x), bgSize.x - 1);
+            const auto bgY = std::min(static_cast<std::uint32_t>((y + 0.5f) / sourceHeight * bgSize.y), bgSize.y - 1);
+            const auto bg = background.getPixel(bgX, bgY);
+
+            const auto idx = y * sourceWidth + x;
+            const auto* ov = reinterpret_cast<const std::uint8_t*>(&overlay[idx]);
+
+            //fragment output is clamped then alpha blended on to the cleared (black) buffer
+            const float alpha = std::min(baseAlpha * (ov[3] / 255.f) + backgroundStrength * (bg.a / 255.f), 1.f);
+            const float bgR = backgroundStrength * (bg.r / 255.f);
+            const float bgG = backgroundStrength * (bg.g / 255.f);
+            const float bgB = backgroundStrength * (bg.b / 255.f);
+
+            m_unlitColours[idx] = packColour(std::min(bgR, 1.f) * alpha, std::min(bgG, 1.f) * alpha, std::min(bgB, 1.f) * alpha, 1.f);
+            m_litColours[idx] = packColour(std::min(ov[0] / 255.f + bgR, 1.f) * alpha,
+                                            std::min(ov[1] / 255.f + bgG, 1.f) * alpha,
+                                            std::min(ov[2] / 255.f + bgB, 1.f) * alpha, 1.f);
+        }
+    }
+}
+
+void Compositor::buildPostTables(std::uint32_t scale)
+{
+    const auto pixelCount = m_width * m_height;
+    m_redIndices.resize(pixelCount);
+    m_greenIndices.resize(pixelCount);
+    m_blueIndices.resize(pixelCount);
+    m_lineSin.resize(pixelCount);
+    m_lineCos.resize(pixelCount);
+    m_grainSeed.resize(pixelCount);
+
+    for (auto y = 0u; y < m_height; ++y)
+    {
+        for (auto x = 0u; x < m_width; ++x)
+        {
+            //the output is the source rotated 90 degrees anti-clockwise
+            const float sourceX = sourceWidth - ((y + 0.5f) / scale);
+            const float sourceY = (x + 0.5f) / scale;
+            float u = sourceX / sourceWidth;
+            float v = 1.f - (sourceY / sourceHeight);
+
+            //barrel distortion
+            const float du = 0.5f - u;
+            const float dv = 0.5f - v;
+            const float distSquared = du * du + dv * dv;
+            if (distSquared > centreDistanceSquared)
+            {
+                u += du * (centreDistanceSquared - distSquared) * 0.12f;
+                v += dv * (centreDistanceSquared - distSquared) * 0.12f;
+            }
+
+            //chromatic aberration
+            const float offsetU = (maxOffset / 2.f) - (u * maxOffset);
+            const float offsetV = (maxOffset / 2.f) - (v * maxOffset);
+
+            const auto idx = y * m_width + x;
+            m_redIndices[idx] = sampleIndex(u + offsetU, v + offsetV);
+            m_greenIndices[idx] = sampleIndex(u, v);
+            m_blueIndices[idx] = sampleIndex(u - offsetU, v - offsetV);
+
+            //cos(a + t) is expanded at runtime so only depends on these
+            m_lineSin[idx] = std::sin(v * lineCount);
+            m_lineCos[idx] = std::cos(v * lineCount);
+            m_grainSeed[idx] = (u + 4.f) * v * 10.f;
+        }
+    }
+}
+
+void Compositor::blendRows(const std::uint8_t* vram, std::uint32_t start, std::uint32_t end)
+{
+    //pixels are packed 8 per byte, LSB first. Each byte selects
+    //between the lit and unlit colours of its 8 pixels with masks
+#ifdef SPIN_COMPOSITOR_SSE
+    const auto lowBits = _mm_set_epi32(8, 4, 2, 1);
+    const auto highBits = _mm_set_epi32(128, 64, 32, 16);
+#endif
+
+    for (auto y = start; y < end; ++y)
+    {
+        const auto* lit = &m_litColours[y * sourceWidth];
+        const auto* unlit = &m_unlitColours[y * sourceWidth];
+        auto* dst = &m_blended[y * sourceWidth];
+        const auto* src = &vram[y * (sourceWidth / 8u)];
+
+        for (auto i = 0u; i < sourceWidth / 8u; ++i)
+        {
+            const auto x = i * 8u;
+#ifdef SPIN_COMPOSITOR_SSE
+            const auto bits = _mm_set1_epi32(src[i]);
+            const auto lowMask = _mm_cmpeq_epi32(_mm_and_si128(bits, lowBits), lowBits);
+            const auto highMask = _mm_cmpeq_epi32(_mm_and_si128(bits, highBits), highBits);
+
+            const auto* litQuad = reinterpret_cast<const __m128i*>(lit + x);
+            const auto* unlitQuad = reinterpret_cast<const __m128i*>(unlit + x);
+            auto* dstQuad = reinterpret_cast<__m128i*>(dst + x);
+            _mm_storeu_si128(dstQuad, _mm_or_si128(_mm_and_si128(lowMask, _mm_loadu_si128(litQuad)),
+                _mm_andnot_si128(lowMask, _mm_loadu_si128(unlitQuad))));
+            _mm_storeu_si128(dstQuad + 1, _mm_or_si128(_mm_and_si128(highMask, _mm_loadu_si128(litQuad + 1)),
+                _mm_andnot_si128(highMask, _mm_loadu_si128(unlitQuad + 1))));
+#else
+            const std::uint32_t bits = src[i];
+            for (auto j = 0u; j < 8u; ++j)
+            {
+                const std::uint32_t mask = 0u - ((bits >> j) & 1u);
+                dst[x + j] = (lit[x + j] & mask) | (unlit[x + j] & ~mask);
+            }
+#endif
+        }
+    }
+}
+
+void Compositor::postRows(float time, std::uint32_t start, std::uint32_t end)
+{
+    const auto* source = reinterpret_cast<const std::uint8_t*>(m_blended.data());
+    const float timeSin = std::sin(time);
+    const float timeCos = std::cos(time);
+
+    for (auto y = start; y < end; ++y)
+    {
+        const auto rowStart = y * m_width;
+        auto* dst = &m_output[rowStart * 4u];
+
+        //the distortion and aberration lookups are done as a separate
+        //pass, leaving the arithmetic below free of gathers
+        for (auto x = 0u; x < m_width; ++x)
+        {
+            const auto idx = rowStart + x;
+            dst[x * 4u] = source[m_redIndices[idx] * 4u];
+            dst[x * 4u + 1u] = source[m_greenIndices[idx] * 4u + 1u];
+            dst[x * 4u + 2u] = source[m_blueIndices[idx] * 4u + 2u];
+        }
+
+        const auto* seeds = &m_grainSeed[rowStart];
+        const auto* lineSins = &m_lineSin[rowStart];
+        const auto* lineCoss = &m_lineCos[rowStart];
+        auto x = 0u;
+
+#ifdef SPIN_COMPOSITOR_SSE
+        //four pixels at a time, transposed so each channel is one register
+        const auto zero = _mm_setzero_si128();
+        const auto alpha = _mm_set1_epi32(0xFF000000);
+        for (; x + 4u <= m_width; x += 4u)
+        {
+            const auto grain = grainQuad(_mm_mul_ps(_mm_loadu_ps(seeds + x), _mm_set1_ps(time)));
+            const auto lineSin = _mm_loadu_ps(lineSins + x);
+            const auto lineCos = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(lineCoss + x), _mm_set1_ps(timeCos)),
+                _mm_mul_ps(lineSin, _mm_set1_ps(timeSin)));
+
+            auto* pixels = reinterpret_cast<__m128i*>(dst + x * 4u);
+            const auto packed = _mm_loadu_si128(pixels);
+            const auto low = _mm_unpacklo_epi8(packed, zero);
+            const auto high = _mm_unpackhi_epi8(packed, zero);
+            auto red = _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero));
+            auto green = _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero));
+            auto blue = _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero));
+            auto unused = _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero));
+            _MM_TRANSPOSE4_PS(red, green, blue, unused);
+
+            const auto r = postChannel(red, grain, lineSin);
+            const auto g = postChannel(green, grain, lineCos);
+            const auto b = postChannel(blue, grain, lineSin);
+            _mm_storeu_si128(pixels, _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)),
+                _mm_or_si128(_mm_slli_epi32(b, 16), alpha)));
+        }
+#endif
+
+        for (; x < m_width; ++x)
+        {
+            const float lineCos = lineCoss[x] * timeCos - lineSins[x] * timeSin;
+            postPixel(dst + x * 4u, grainValue(seeds[x] * time), lineSins[x], lineCos);
+        }
+    }
+}
+
+void Compositor::processBand(std::uint32_t band)
+{
+    const auto bandCount = static_cast<std::uint32_t>(m_threads.size()) + 1u;
+    if (m_stage == Stage::Blend)
+    {
+        blendRows(m_vram, (sourceHeight * band) / bandCount, (sourceHeight * (band + 1)) / bandCount);
+    }
+    else
+    {
+        postRows(m_time, (m_height * band) / bandCount, (m_height * (band + 1)) / bandCount);
+    }
+}
+
+void Compositor::runStage(Stage stage)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stage = stage;
+        m_pendingCount = static_cast<std::uint32_t>(m_threads.size());
+        m_generation++;
+    }
+    m_startCondition.notify_all();
+
+    processBand(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this]() {return m_pendingCount == 0; });
+}
+
+void Compositor::threadFunc(std::uint32_t band)
+{
+    std::uint32_t generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_startCondition.wait(lock, [this, generation]() {return !m_running || m_generation != generation; });
+            if (!m_running) return;
+            generation = m_generation;
+        }
+
+        processBand(band);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pendingCount--;
+        }
+        m_doneCondition.notify_one();
+    }
+}
@@ -0,0 +1,89 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <CoverageReport.hpp>
+#include <Board.hpp>
+
+#include <SFML/Graphics/Image.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+    struct Region final
+    {
+        const char* name;
+        Word address;
+        std::uint32_t size;
+    };
+
+    //RAM is reported by access counts rather than execution
+    const std::array<Region, 2> ramRegions =
+    {
+        {
+            { "work ram", 0x2000, 0x400 },
+            { "video ram", 0x2400, I8080::VRAM_SIZE }
+        }
+    };
+
+    void writeRegion(std::ofstream& file, const I8080::CoverageMap& coverage, const std::string& name, Word address, std::uint32_t size)
+    {
+        const auto summary = coverage.getSummary(address, size);
+        const auto percent = (size > 0) ? (100.0 * summary.executed) / size : 0.0;
+
+        char range[16];
+        std::snprintf(range, sizeof(range), "0x%04X,0x%04X", address, address + size - 1);
+        file << name << "," << range << "," << size << ","
+            << summary.executed << "," << percent << ","
+            << summary.read << "," << summary.written << "\n";
+    }
+}
+
+bool CoverageReport::writeRegions(const Board& board, const std::string& path)
+{
+    std::ofstream file(path);
+    if (!file.good()) return false;
+
+    const auto& coverage = board.getProcessor().getCoverage();
+    file << "region,start,end,size,executed_bytes,executed_percent,read_bytes,written_bytes\n";
+    for (const auto& chip : board.getRomChips())
+    {
+        writeRegion(file, coverage, chip.path, chip.address, chip.size);
+    }
+    for (const auto& region : ramRegions)
+    {
+        writeRegion(file, coverage, region.name, region.address, region.size);
+    }
+    return file.good();
+}
+
+bool CoverageReport::writeHeatmap(const Board& board, const std::string& path)
+{
+    std::vector<std::uint8_t> pixels;
+    board.getProcessor().getCoverage().getHeatmap(pixels);
+
+    sf::Image image;
+    image.create(I8080::CoverageMap::HeatmapSize, I8080::CoverageMap::HeatmapSize, pixels.data());
+    return image.saveToFile(path);
+}
\ No newline at end of file
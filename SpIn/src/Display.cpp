@@ -23,6 +23,7 @@ source distribution.
 
 #include <Display.hpp>
 #include <PostChromeAb.hpp>
+#include <Trace.hpp>
 
 #include <SFML/Graphics/RenderStates.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
@@ -31,13 +32,13 @@ source distribution.
 #include <SFML/System/Clock.hpp>
 
 #include <cstring>
-#include <functional>
 #include <iostream>
 
 namespace
 {
     const sf::Uint32 width = 256u;
     const sf::Uint32 height = 224u;
+    const sf::Uint32 bytesPerRow = width / 8u;
 
     const std::string shader =
         "#version 120\n"
@@ -54,6 +55,28 @@ namespace
         "}\n";
 
     sf::Clock postClock;
+
+    //each VRAM byte expands to 8 RGBA pixels, so rather
+    //than testing each bit look up the whole run of pixels
+    using PixelRun = std::array<sf::Uint32, 8u>;
+    std::array<PixelRun, 256u> createPixelTable()
+    {
+        std::array<PixelRun, 256u> table;
+        for (auto i = 0u; i < table.size(); ++i)
+        {
+            for (auto j = 0u; j < 8u; ++j)
+            {
+                sf::Uint8 val = (i & (1 << j)) ? 0xFF : 0;
+                sf::Uint8* pixel = reinterpret_cast<sf::Uint8*>(&table[i][j]);
+                pixel[0] = val;
+                pixel[1] = val;
+                pixel[2] = val;
+                pixel[3] = 0xFF;
+            }
+        }
+        return table;
+    }
+    const std::array<PixelRun, 256u> pixelTable = createPixelTable();
 }
 
 Display::Display()
@@ -73,27 +96,9 @@ Display::Display()
 
     //ok so SFML forces us to use RGBA textures (ideally we'd want GL_LUMINENCE or so)
     //but because we're emulating we'll "emulate" the original overlay with a custom
-    //texture and then multiply it (with a shader for performance)
-    img.create(width, height, sf::Color::White);
-
-    std::function<void(std::uint16_t, std::uint16_t, std::uint16_t, std::uint16_t, sf::Color)> updateColour =
-        [&img](std::uint16_t x , std::uint16_t y, std::uint16_t w, std::uint16_t h, sf::Color c)
-    {
-        for (auto j = y; j < y + h; ++j)
-        {
-            for (auto i = x; i < x + w; ++i)
-            {
-                img.setPixel(i, j, c);
-            }
-        }
-    };
-
-    updateColour(222, 0, 34, 224, sf::Color::Yellow);
-    updateColour(208, 0, 12, 224, sf::Color::Red);
-    updateColour(18, 0, 56, 224, sf::Color::Green);
-    updateColour(0, 0, 16, 136, sf::Color::Green);
-
-    m_overlayTexture.loadFromImage(img);
+    //texture and then multiply it (with a shader for performance). It's left clear
+    //until a game is loaded
+    setOverlay({});
 
     m_blendShader.loadFromMemory(shader, sf::Shader::Fragment);
     m_blendShader.setParameter("u_baseTexture", m_baseTexture);
@@ -114,30 +119,72 @@ Display::Display()
 }
 
 //public 
-void Display::updateBuffer(const std::uint8_t* buffer)
+void Display::setOverlay(const std::vector<Overlay::Region>& regions)
 {
-    //pixels are packed 8 per byte so need to be translated to local buffer
-    for (auto i = 0, b = 0; i < 7168; ++i)
+    sf::Image img;
+    img.create(width, height, sf::Color::White);
+
+    for (const auto& region : regions)
     {
-        for (auto j = 0; j < 8; ++j)
+        const sf::Color colour(region.r, region.g, region.b);
+        for (auto j = region.y; j < region.y + region.height; ++j)
         {
-            std::uint8_t val = (buffer[i] & (1 << j)) ? 0xFF : 0;
-            m_buffer[b++] = val;
-            m_buffer[b++] = val;
-            m_buffer[b++] = val;
-            m_buffer[b++] = 0xFF;
+            for (auto i = region.x; i < region.x + region.width; ++i)
+            {
+                img.setPixel(i, j, colour);
+            }
         }
     }
 
-    sf::Texture::bind(&m_baseTexture);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, m_buffer.data());
-    sf::Texture::bind(nullptr);
+    m_overlayTexture.loadFromImage(img);
+}
 
+void Display::updateBuffer(const std::uint8_t* buffer)
+{
+    SPIN_TRACE_SCOPE("Display::updateBuffer");
+    updateRows(buffer, 0, height);
     m_postShader.setParameter("u_time", postClock.getElapsedTime().asSeconds());
 }
 
+void Display::updateBuffer(const std::uint8_t* buffer, Half half)
+{
+    SPIN_TRACE_SCOPE("Display::updateBuffer");
+    const sf::Uint32 rowCount = height / 2u;
+    if (half == Half::Top)
+    {
+        updateRows(buffer, 0, rowCount);
+    }
+    else
+    {
+        updateRows(buffer, rowCount, rowCount);
+        //bottom half completes the frame
+        m_postShader.setParameter("u_time", postClock.getElapsedTime().asSeconds());
+    }
+}
+
+void Display::convertRows(const std::uint8_t* vram, std::uint8_t* rgba, std::uint32_t start, std::uint32_t count)
+{
+    //pixels are packed 8 per byte so need to be translated to local buffer
+    const auto first = start * bytesPerRow;
+    const auto last = first + (count * bytesPerRow);
+    for (auto i = first; i < last; ++i)
+    {
+        std::memcpy(&rgba[i * sizeof(PixelRun)], pixelTable[vram[i]].data(), sizeof(PixelRun));
+    }
+}
+
 
 //private
+void Display::updateRows(const std::uint8_t* buffer, std::uint32_t start, std::uint32_t count)
+{
+    convertRows(buffer, m_buffer.data(), start, count);
+
+    const auto first = start * bytesPerRow;
+    sf::Texture::bind(&m_baseTexture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, start, width, count, GL_RGBA, GL_UNSIGNED_BYTE, &m_buffer[first * sizeof(PixelRun)]);
+    sf::Texture::bind(nullptr);
+}
+
 void Display::draw(sf::RenderTarget& rt, sf::RenderStates states) const
 {
     states.texture = &m_baseTexture;
@@ -0,0 +1,157 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <Headless.hpp>
+#include <CoverageReport.hpp>
+
+#include <chrono>
+#include <iostream>
+
+namespace
+{
+    const std::uint32_t samplesPerFrame = Mixer::SampleRate / Board::FramesPerSecond;
+}
+
+Headless::Headless(const Options& options)
+    : m_options     (options),
+    m_audioBuffer   (samplesPerFrame)
+{
+    //the synthesiser needs no assets, so is used if the samples are missing
+    m_mixer.setSource(m_options.soundSource);
+    if (m_options.soundSource == Mixer::Source::Samples
+        && !m_mixer.loadSamples())
+    {
+        std::cout << "No sound samples found in assets/sounds, using the synthesiser" << std::endl;
+        m_mixer.setSource(Mixer::Source::Synth);
+    }
+
+    m_board.setSoundHandler([this](std::int32_t id, bool start, std::uint64_t cycle)
+    {
+        m_mixer.queueEvent(id, start, static_cast<std::uint32_t>(m_board.getFramePosition(cycle) * samplesPerFrame));
+    });
+}
+
+//public
+int Headless::run()
+{
+    auto& processor = m_board.getProcessor();
+    processor.setFeatures(m_options.getProcessorFeatures());
+    if (!m_options.symbolsPath.empty()
+        && !processor.getCallProfiler().loadSymbols(m_options.symbolsPath))
+    {
+        std::cout << "Failed loading symbols from " << m_options.symbolsPath << std::endl;
+    }
+    if (!m_options.instructionTracePath.empty()
+        && !processor.openInstructionTrace(m_options.instructionTracePath))
+    {
+        std::cout << "Failed opening instruction trace " << m_options.instructionTracePath << std::endl;
+    }
+
+    //there's no one to step, so breakpoints and
+    //watchpoints are logged and execution continues
+    auto& debugger = processor.getDebugger();
+    for (auto address : m_options.breakpoints)
+    {
+        debugger.addBreakpoint(address);
+    }
+    for (const auto& watchpoint : m_options.watchpoints)
+    {
+        debugger.addWatchpoint(watchpoint);
+    }
+
+    if (!m_board.loadGame(m_options.game))
+    {
+        return 1;
+    }
+    if (m_options.highLevel)
+    {
+        std::cout << processor.getHookCount() << " ROM routines will run natively" << std::endl;
+    }
+
+    auto settings = m_options.recording;
+    settings.overlay = m_board.getDefinition().getOverlay();
+    const bool recording = (!settings.videoPath.empty() || !settings.audioPath.empty());
+    if (recording && !m_recorder.start(settings))
+    {
+        return 1;
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    for (auto i = 0u; i < m_options.frameCount; ++i)
+    {
+        while (!m_board.update())
+        {
+            std::cout << "Frame " << i << ": " << debugger.getStopDescription() << std::endl;
+            debugger.resume();
+        }
+        if (recording)
+        {
+            m_mixer.mix(m_audioBuffer.data(), samplesPerFrame);
+            m_recorder.pushFrame(m_board.getVRAM(), m_audioBuffer.data(), samplesPerFrame);
+        }
+    }
+    m_recorder.stop();
+
+    if (!m_options.opcodeStatsPath.empty()
+        && !processor.writeOpcodeStats(m_options.opcodeStatsPath))
+    {
+        std::cout << "Failed writing opcode stats to " << m_options.opcodeStatsPath << std::endl;
+    }
+    if (!m_options.sequenceStatsPath.empty()
+        && !processor.writeSequenceStats(m_options.sequenceStatsPath))
+    {
+        std::cout << "Failed writing sequence stats to " << m_options.sequenceStatsPath << std::endl;
+    }
+    if (!m_options.callGraphPath.empty()
+        && !processor.getCallProfiler().writeFoldedStacks(m_options.callGraphPath))
+    {
+        std::cout << "Failed writing call graph to " << m_options.callGraphPath << std::endl;
+    }
+    if (!m_options.routineStatsPath.empty()
+        && !processor.getCallProfiler().writeRoutines(m_options.routineStatsPath))
+    {
+        std::cout << "Failed writing routine stats to " << m_options.routineStatsPath << std::endl;
+    }
+    if (!m_options.coveragePath.empty()
+        && !CoverageReport::writeRegions(m_board, m_options.coveragePath))
+    {
+        std::cout << "Failed writing coverage to " << m_options.coveragePath << std::endl;
+    }
+    if (!m_options.heatmapPath.empty()
+        && !CoverageReport::writeHeatmap(m_board, m_options.heatmapPath))
+    {
+        std::cout << "Failed saving heatmap to " << m_options.heatmapPath << std::endl;
+    }
+    processor.closeInstructionTrace();
+
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    const auto emulated = static_cast<double>(m_options.frameCount) / Board::FramesPerSecond;
+    std::cout << "Ran " << m_options.frameCount << " frames (" << emulated << "s) in " << elapsed << "s";
+    if (elapsed > 0)
+    {
+        std::cout << ", " << (emulated / elapsed) << "x real time";
+    }
+    std::cout << std::endl;
+
+    return 0;
+}
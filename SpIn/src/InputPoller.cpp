@@ -0,0 +1,91 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <InputPoller.hpp>
+#include <InputState.hpp>
+
+#include <chrono>
+
+InputPoller::InputPoller(InputState& inputState)
+    : m_inputState  (inputState),
+    m_running       (false),
+    m_enabled       (true)
+{
+
+}
+
+InputPoller::~InputPoller()
+{
+    stop();
+}
+
+//public
+void InputPoller::start(std::uint32_t rate)
+{
+    if (m_running) return;
+
+    m_running = true;
+    m_thread = std::thread(&InputPoller::threadFunc, this, rate);
+}
+
+void InputPoller::stop()
+{
+    m_running = false;
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+void InputPoller::setMappings(const std::vector<KeyBindings::Mapping>& mappings)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mappings = mappings;
+}
+
+//private
+void InputPoller::threadFunc(std::uint32_t rate)
+{
+    const auto interval = std::chrono::microseconds(1000000 / ((rate > 0) ? rate : 1u));
+    auto nextPoll = std::chrono::steady_clock::now();
+
+    while (m_running)
+    {
+        std::uint64_t bits = 0;
+        if (m_enabled)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& mapping : m_mappings)
+            {
+                if (sf::Keyboard::isKeyPressed(mapping.key))
+                {
+                    bits |= std::uint64_t(1) << (mapping.bit + InputState::getShift(mapping.port));
+                }
+            }
+        }
+        m_inputState.store(bits);
+
+        nextPoll += interval;
+        std::this_thread::sleep_until(nextPoll);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,199 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <LatencyTracker.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+constexpr std::size_t LatencyTracker::Histogram::BucketCount;
+
+namespace
+{
+    //the guest doesn't always read the controls, for example
+    //between games, so measurements are abandoned after this
+    const std::chrono::milliseconds timeout(1000);
+
+    const std::array<const char*, LatencyTracker::StageCount> stageNames =
+    {
+        "Input > IN",
+        "IN > Present",
+        "Total"
+    };
+
+    float toMilliseconds(std::chrono::steady_clock::duration duration)
+    {
+        return std::chrono::duration<float, std::milli>(duration).count();
+    }
+}
+
+LatencyTracker::Histogram::Histogram()
+    : m_count   (0),
+    m_sum       (0.0),
+    m_max       (0.f)
+{
+    m_buckets.fill(0);
+}
+
+void LatencyTracker::Histogram::add(float ms)
+{
+    const auto bucket = std::min(static_cast<std::size_t>(std::max(ms, 0.f)), BucketCount - 1);
+    m_buckets[bucket]++;
+    m_count++;
+    m_sum += ms;
+    m_max = std::max(m_max, ms);
+}
+
+float LatencyTracker::Histogram::getMean() const
+{
+    return (m_count > 0) ? static_cast<float>(m_sum / m_count) : 0.f;
+}
+
+float LatencyTracker::Histogram::getPercentile(float percentile) const
+{
+    if (m_count == 0) return 0.f;
+
+    const auto target = static_cast<std::uint32_t>(std::ceil(percentile * m_count));
+    std::uint32_t total = 0;
+    for (auto i = 0u; i < BucketCount; ++i)
+    {
+        total += m_buckets[i];
+        if (total >= target)
+        {
+            return static_cast<float>(i + 1);
+        }
+    }
+    return static_cast<float>(BucketCount);
+}
+
+LatencyTracker::LatencyTracker()
+    : m_state   (State::Idle),
+    m_port      (0),
+    m_mask      (0),
+    m_expected  (0)
+{
+
+}
+
+LatencyTracker::~LatencyTracker()
+{
+    if (m_log.is_open())
+    {
+        std::stringstream ss;
+        ss << getSummary();
+
+        std::string line;
+        while (std::getline(ss, line))
+        {
+            m_log << "# " << line << "\n";
+        }
+    }
+}
+
+//public
+bool LatencyTracker::openLog(const std::string& path)
+{
+    m_log.open(path);
+    if (!m_log.is_open()) return false;
+
+    m_log << "input_to_read_ms,read_to_present_ms,total_ms\n";
+    return true;
+}
+
+void LatencyTracker::inputArrived(std::size_t port, Byte bit, bool pressed)
+{
+    if (m_state != State::Idle) return;
+
+    m_port = port;
+    m_mask = static_cast<Byte>(1 << bit);
+    m_expected = pressed ? m_mask : 0;
+    m_timestamps[0] = Clock::now();
+    m_state = State::WaitingForRead;
+}
+
+void LatencyTracker::portRead(std::size_t port, Byte value)
+{
+    //reads made before the input reached the port, for example
+    //when it's polled on another thread, don't count
+    if (m_state != State::WaitingForRead || port != m_port
+        || (value & m_mask) != m_expected) return;
+
+    m_timestamps[1] = Clock::now();
+    m_state = State::WaitingForPresent;
+}
+
+void LatencyTracker::presented()
+{
+    if (m_state == State::Idle) return;
+
+    const auto now = Clock::now();
+    if (m_state == State::WaitingForPresent)
+    {
+        m_timestamps[2] = now;
+        complete();
+    }
+    else if (now - m_timestamps[0] > timeout)
+    {
+        m_state = State::Idle;
+    }
+}
+
+std::string LatencyTracker::getSummary() const
+{
+    std::stringstream ss;
+    ss << "Latency (ms, " << getSampleCount() << " inputs)\n";
+    ss << std::fixed << std::setprecision(1);
+    for (auto i = 0u; i < StageCount; ++i)
+    {
+        const auto& histogram = m_histograms[i];
+        ss << stageNames[i] << ": mean " << histogram.getMean()
+            << " p95 " << histogram.getPercentile(0.95f)
+            << " max " << histogram.getMax() << "\n";
+    }
+    return ss.str();
+}
+
+//private
+void LatencyTracker::complete()
+{
+    std::array<float, StageCount> times =
+    {{
+        toMilliseconds(m_timestamps[1] - m_timestamps[0]),
+        toMilliseconds(m_timestamps[2] - m_timestamps[1]),
+        toMilliseconds(m_timestamps[2] - m_timestamps[0])
+    }};
+
+    for (auto i = 0u; i < StageCount; ++i)
+    {
+        m_histograms[i].add(times[i]);
+    }
+
+    if (m_log.is_open())
+    {
+        m_log << times[0] << "," << times[1] << "," << times[2] << "\n";
+    }
+
+    m_state = State::Idle;
+}
\ No newline at end of file
@@ -22,22 +22,66 @@ source distribution.
 *********************************************************************/
 
 #include <Machine.hpp>
+#include <KeyBindings.hpp>
+#include <Trace.hpp>
+#include <CoverageReport.hpp>
 
 #include <SFML/Window/Event.hpp>
 #include <SFML/System/Clock.hpp>
+#include <SFML/System/Sleep.hpp>
 
-#include <cassert>
-#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
 
-Machine::Machine()
-    : m_shiftValue  (0),
-    m_shiftOffset   (0)
+namespace
 {
+    const std::uint32_t samplesPerFrame = Mixer::SampleRate / Board::FramesPerSecond;
+
+    //if the host falls further behind than this the
+    //remaining time is dropped rather than caught up
+    const std::int32_t maxCatchUpFrames = 4;
+
+    //audio pacing keeps this many samples queued in the stream. A frame
+    //is due once the fill drops half a frame's audio below the target,
+    //so that on average the stream sits at the target after pushing it
+    const std::size_t targetFill = 2048u;
+    const std::size_t frameDueFill = targetFill - samplesPerFrame / 2;
+
+    //the most the audio is stretched or squashed to reach
+    //the target fill, small enough not to hear the pitch change
+    const double maxRateDeviation = 0.005;
+    const double fillSmoothing = 0.05;
+
+    //the heatmap overlay is refreshed this often, in emulated frames
+    const std::uint64_t heatmapInterval = 15u;
+}
+
+Machine::Machine(const Options& options)
+    : m_options               (options),
+    m_inputPoller             (m_inputState),
+    m_audioStream             (Mixer::SampleRate),
+    m_audioBuffer             (samplesPerFrame),
+    m_resampleBuffer          (samplesPerFrame * 2),
+    m_averageFill             (static_cast<double>(targetFill)),
+    m_turbo                   (false),
+    m_presenting              (true),
+    m_speculating             (false),
+    m_showLatency             (false),
+    m_latencySampleCount      (0),
+    m_showHeatmap             (false),
+    m_featuresBeforeHeatmap   (0)
+{
+    m_heatmapTexture.create(I8080::CoverageMap::HeatmapSize, I8080::CoverageMap::HeatmapSize);
+    m_heatmapSprite.setTexture(m_heatmapTexture);
+    m_heatmapSprite.setScale(2.f, 2.f);
+    m_heatmapSprite.setPosition(256.f, 128.f);
+    m_heatmapSprite.setColor({ 255, 255, 255, 220 });
+
     if (m_font.loadFromFile("assets/fonts/VeraMono.ttf"))
     {
-        m_infoText.setFont(m_font);
-        m_infoText.setPosition(15.f, 15.f);
-        m_infoText.setCharacterSize(12u);
+        m_perfHud.setFont(m_font);
+        m_perfHud.setPosition(15.f, 15.f);
 
         m_instructionText.setFont(m_font);
         m_instructionText.setPosition(850.f, 20.f);
@@ -58,304 +102,492 @@ Machine::Machine()
             "RControl - Fire\n"
             "\n\n"
             "F1 - Space Invaders\n"
-            "F2 - Balloon Bomber\n"
-            "F3 - Lunar Rescue\n"
+            "Tab - Fast Forward\n"
+            "F5 - Break / Continue\n"
+            "F6 - Step Into\n"
+            "F7 - Step Over\n"
+            "F8 - Step Out\n"
+            "F9 - Latency Stats\n"
+            "F10 - Performance Stats\n"
+            "F12 - Memory Heatmap\n"
             "Escape - Quit");
+
+        m_latencyText.setFont(m_font);
+        m_latencyText.setPosition(850.f, 420.f);
+        m_latencyText.setCharacterSize(12u);
+        m_latencyText.setString(m_latencyTracker.getSummary());
+    }
+
+    if (!m_options.latencyLogPath.empty())
+    {
+        m_latencyTracker.openLog(m_options.latencyLogPath);
     }
 
-    I8080::CPU::InputHandler ih = [this](Byte port)->Byte
+    //the synthesiser needs no assets, so is used if the samples are missing
+    m_mixer.setSource(m_options.soundSource);
+    if (m_options.soundSource == Mixer::Source::Samples
+        && !m_mixer.loadSamples())
     {
-        switch (port)
+        std::cout << "No sound samples found in assets/sounds, using the synthesiser" << std::endl;
+        m_mixer.setSource(Mixer::Source::Synth);
+    }
+
+    m_board.setInputState(&m_inputState);
+
+    m_board.setRasterHandler([this](const Byte* vram, Board::Half half)
+    {
+        if (m_presenting)
         {
-        default: return 0;
-        case 1:
-            return m_ports[1];
-            break;
-        case 2:
-            return m_ports[2];
-            break;
-        case 3:
-            return static_cast<Byte>(((m_shiftValue << m_shiftOffset) & 0xFF));
-            break;
+            const auto start = std::chrono::steady_clock::now();
+            m_display.updateBuffer(vram, (half == Board::Half::Top) ? Display::Half::Top : Display::Half::Bottom);
+            m_perfHud.addUploadTime(std::chrono::steady_clock::now() - start);
         }
-    };
-    m_processor.setInputHandler(ih);
+    });
 
-    I8080::CPU::OutputHandler oh = [this](Byte port, Byte value)
+    m_board.setPortReadHandler([this](std::size_t port, Byte value)
     {
-        switch (port)
+        //run ahead frames are rolled back, so the read hasn't happened yet
+        if (!m_speculating)
         {
-        default: break;
-        case 2:
-            m_shiftOffset = value;
-            break;
-        case 3:
-            //sound
-            //bit 1 = spaceship sound (looped)
-            //bit 2 = Shot
-            //bit 3 = Your ship hit
-            //bit 4 = Invader hit
-            //bit 5 = Extended play sound
-        {
-            //get bits which changed
-            auto changed = m_ports[3] ^ value;
-            for (auto i = 0; i < 8; ++i)
-            {
-                if ((changed & (1 << i)) && (value & (1 << i)))
-                {
-                    //sound started
-                    m_soundPlayer.play(i);
-                }
-                else
-                {
-                    //sound stopped
-                }
-            }
-
-            m_ports[3] = value;
+            m_latencyTracker.portRead(port, value);
         }
-            break;
-        case 4:
-            m_shiftValue = (m_shiftValue << 8) | value;
-            break;
-        case 5:
-            //bit 0 = invaders sound 1
-            //bit 1 = invaders sound 2
-            //bit 2 = invaders sound 3
-            //bit 3 = invaders sound 4
-            //bit 4 = spaceship hit
-            //bit 5 = amplifier enabled/disabled (presumably this mutes the machine?)
-        {
-            auto changed = m_ports[5] ^ value;
-            for (auto i = 0; i < 8; ++i)
-            {
-                if (changed & (1 << i) && (value & (1 << i)))
-                {
-                    //sound started
-                    m_soundPlayer.play(i + 10);
-                }
-                else
-                {
-                    //sound stopped
-                }
-            }
+    });
 
-            m_ports[5] = value;
-        }
-            break;
-        }
-    };
-    m_processor.setOutputHandler(oh);
-    std::memset(m_ports.data(), 0, I8080::PORT_COUNT);
+    m_board.setSoundHandler([this](std::int32_t id, bool start, std::uint64_t cycle)
+    {
+        //run ahead frames are thrown away so mustn't be heard
+        if (m_speculating) return;
+
+        m_mixer.queueEvent(id, start, static_cast<std::uint32_t>(m_board.getFramePosition(cycle) * samplesPerFrame));
+    });
 }
 
 //public
 void Machine::run()
 {
     m_renderWindow.create({ 1024, 768 }, "SpIn");
-    m_renderWindow.setFramerateLimit(120);
+    m_renderWindow.setKeyRepeatEnabled(false);
+
+    auto& processor = m_board.getProcessor();
+    processor.setFeatures(m_options.getProcessorFeatures());
+    if (!m_options.symbolsPath.empty()
+        && !processor.getCallProfiler().loadSymbols(m_options.symbolsPath))
+    {
+        std::cout << "Failed loading symbols from " << m_options.symbolsPath << std::endl;
+    }
+    if (!m_options.instructionTracePath.empty()
+        && !processor.openInstructionTrace(m_options.instructionTracePath))
+    {
+        std::cout << "Failed opening instruction trace " << m_options.instructionTracePath << std::endl;
+    }
 
+    auto& debugger = processor.getDebugger();
+    for (auto address : m_options.breakpoints)
+    {
+        debugger.addBreakpoint(address);
+    }
+    for (const auto& watchpoint : m_options.watchpoints)
+    {
+        debugger.addWatchpoint(watchpoint);
+    }
+
+    if (m_options.hasGame)
+    {
+        loadGame(m_options.game);
+    }
+
+    if (!m_options.recording.videoPath.empty() || !m_options.recording.audioPath.empty())
+    {
+        //the overlay of the game loaded at start is composited in to the video
+        auto settings = m_options.recording;
+        settings.overlay = m_board.getDefinition().getOverlay();
+        m_recorder.start(settings);
+    }
+
+    //start with the buffer at its target so rate
+    //control doesn't have to slowly fill it
+    if (m_options.pacing == Options::Pacing::Audio)
+    {
+        const std::vector<std::int16_t> silence(targetFill);
+        m_audioStream.push(silence.data(), silence.size());
+    }
+    m_audioStream.play();
+
+    if (m_options.inputThread)
+    {
+        m_inputPoller.start();
+    }
+
+    const auto timestep = sf::microseconds(1000000 / Board::FramesPerSecond);
     sf::Clock frameClock;
+    sf::Time accumulator;
 
     while (m_renderWindow.isOpen())
     {
-        sf::Event evt;
-        while (m_renderWindow.pollEvent(evt))
         {
-            if (evt.type == sf::Event::Closed)
+            SPIN_TRACE_SCOPE("Poll events");
+            sf::Event evt;
+            while (m_renderWindow.pollEvent(evt))
+            {
+                if (evt.type == sf::Event::Closed)
+                {
+                    m_renderWindow.close();
+                }
+                handleEvent(evt);
+            }
+        }
+
+        if (m_turbo)
+        {
+            //run flat out, only presenting the last of each batch of frames
+            for (auto i = 1u; i <= m_options.turboFrameSkip; ++i)
+            {
+                update(i == m_options.turboFrameSkip);
+            }
+            draw();
+
+            frameClock.restart();
+            accumulator = sf::Time::Zero;
+            continue;
+        }
+
+        //no audio is produced while the debugger has the CPU stopped,
+        //so the host clock paces the loop until it's resumed
+        if (m_options.pacing == Options::Pacing::Audio
+            && !m_board.getProcessor().getDebugger().isStopped())
+        {
+            //the audio device clock decides when a frame runs: one is emulated
+            //each time the stream drains to the due mark, and rate control
+            //trims the resampling so the host and device clocks don't drift
+            auto frames = 0;
+            while (m_audioStream.getQueuedCount() <= frameDueFill
+                && frames++ < maxCatchUpFrames)
+            {
+                update();
+            }
+            draw();
+
+            //sleep until the device will have played down to the due mark
+            const auto queued = m_audioStream.getQueuedCount();
+            if (queued > frameDueFill)
             {
-                m_renderWindow.close();
+                const auto excess = std::min<std::size_t>(queued - frameDueFill, samplesPerFrame);
+                sf::sleep(sf::microseconds(static_cast<sf::Int64>(excess * 1000000u / Mixer::SampleRate)));
             }
-            handleEvent(evt);
+            frameClock.restart();
+            continue;
+        }
+
+        accumulator += frameClock.restart();
+        if (accumulator > timestep * static_cast<sf::Int64>(maxCatchUpFrames))
+        {
+            accumulator = timestep * static_cast<sf::Int64>(maxCatchUpFrames);
         }
 
-        static const float timestep = 1.f / 60.f;
-        static float accumulator = 0.f;
-        accumulator += frameClock.restart().asSeconds();
         while (accumulator >= timestep)
         {
-            update(timestep);
             accumulator -= timestep;
+            update();
         }
 
         draw();
+
+        //sleep until the next frame is due rather than spinning
+        const auto remaining = timestep - accumulator - frameClock.getElapsedTime();
+        if (remaining > sf::Time::Zero)
+        {
+            sf::sleep(remaining);
+        }
+    }
+
+    m_inputPoller.stop();
+    m_audioStream.stop();
+    m_recorder.stop();
+
+    if (!m_options.opcodeStatsPath.empty())
+    {
+        processor.writeOpcodeStats(m_options.opcodeStatsPath);
+    }
+    if (!m_options.sequenceStatsPath.empty())
+    {
+        processor.writeSequenceStats(m_options.sequenceStatsPath);
+    }
+    if (!m_options.callGraphPath.empty())
+    {
+        processor.getCallProfiler().writeFoldedStacks(m_options.callGraphPath);
+    }
+    if (!m_options.routineStatsPath.empty())
+    {
+        processor.getCallProfiler().writeRoutines(m_options.routineStatsPath);
+    }
+    if (!m_options.coveragePath.empty())
+    {
+        CoverageReport::writeRegions(m_board, m_options.coveragePath);
+    }
+    if (!m_options.heatmapPath.empty())
+    {
+        CoverageReport::writeHeatmap(m_board, m_options.heatmapPath);
     }
+    processor.closeInstructionTrace();
 }
 
 //private
-void Machine::loadGame(Game game)
+void Machine::loadGame(const std::string& name)
 {
-    switch (game)
-    {
-    case Game::SpaceInvaders:
-        m_processor.loadROM("assets/roms/invaders.h", 0);
-        m_processor.loadROM("assets/roms/invaders.g", 0x0800, false);
-        m_processor.loadROM("assets/roms/invaders.f", 0x1000, false);
-        m_processor.loadROM("assets/roms/invaders.e", 0x1800, false);
-        break;
-    case Game::LunarRescue:
-        m_processor.loadROM("assets/roms/lrescue.1", 0);
-        m_processor.loadROM("assets/roms/lrescue.2", 0x800, false);
-        m_processor.loadROM("assets/roms/lrescue.3", 0x1000, false);
-        m_processor.loadROM("assets/roms/lrescue.4", 0x1800, false);
-        m_processor.loadROM("assets/roms/lrescue.5", 0x4000, false);
-        m_processor.loadROM("assets/roms/lrescue.6", 0x4800, false);
-        break;
-    case Game::BalloonBomber:
-        m_processor.loadROM("assets/roms/tn01", 0);
-        m_processor.loadROM("assets/roms/tn02", 0x800, false);
-        m_processor.loadROM("assets/roms/tn03", 0x1000, false);
-        m_processor.loadROM("assets/roms/tn04", 0x1800, false);
-        m_processor.loadROM("assets/roms/tn05-1", 0x4000, false);
-        break;
-    default:break;
-    }
-#ifdef DEBUG_TOOLS
-    m_processor.disassemble();
-#endif //DEBUG_TOOLS
+    m_board.loadGame(name);
+    m_mixer.reset();
+
+    const auto& definition = m_board.getDefinition();
+    m_display.setOverlay(definition.getOverlay());
+
+    //keys are bound to named inputs, so are resolved against each game
+    m_keyMappings.clear();
+    for (const auto& binding : KeyBindings::bindings)
+    {
+        const auto* input = definition.findInput(binding.input);
+        if (input && input->port < InputState::PortCount)
+        {
+            m_keyMappings.push_back({ binding.key, input->port, input->bit });
+        }
+    }
+    m_inputPoller.setMappings(m_keyMappings);
+    m_inputState.store(0);
 }
 
-void Machine::update(float dt)
-{    
-    //33,333 * 60 = 1,999,980
-    //as close as we get to 2MHz
-    m_processor.update(17000);
-    m_processor.raiseInterrupt(1);
-    m_processor.update(16333);
-    m_processor.raiseInterrupt(2);
-
-    m_display.updateBuffer(m_processor.getVRAM());
-    m_infoText.setString(m_processor.getInfo());
+void Machine::update(bool present)
+{
+    SPIN_TRACE_SCOPE("Machine::update");
+    const auto& debugger = m_board.getProcessor().getDebugger();
+    if (debugger.isStopped()) return;
+
+    //speculative frames would stop at breakpoints too
+    const bool runAhead = (present && m_options.runAheadFrames > 0 && !debugger.isActive());
+
+    m_presenting = (present && !runAhead);
+    m_board.update();
+    if (debugger.isStopped())
+    {
+        auto& processor = m_board.getProcessor();
+        auto& disassembler = processor.getDisassembler();
+        disassembler.addEntryPoint(processor.getProgramCounter());
+        std::cout << debugger.getStopDescription() << "\n" << processor.getInfo()
+            << disassembler.getListing(processor.getProgramCounter(), 8) << std::flush;
+    }
+    if (runAhead)
+    {
+        updateRunAhead();
+    }
+    const auto& processor = m_board.getProcessor();
+    m_perfHud.addEmulatedFrame(processor.getCycleCount(), processor.getInstructionCount());
+
+    //the mixer still runs when muted so sound events are consumed
+    m_mixer.mix(m_audioBuffer.data(), samplesPerFrame);
+    if (m_turbo)
+    {
+        //frames are emulated far faster than the device plays them, so
+        //decimate to real time by only passing on whole frames of audio
+        //when the stream has drained, rather than overflowing its buffer
+        if (m_options.turboAudio
+            && m_audioStream.getQueuedCount() <= frameDueFill)
+        {
+            m_audioStream.push(m_audioBuffer.data(), samplesPerFrame);
+        }
+    }
+    else if (m_options.pacing == Options::Pacing::Audio)
+    {
+        const auto count = m_resampler.process(m_audioBuffer.data(), samplesPerFrame,
+            m_resampleBuffer.data(), static_cast<std::uint32_t>(m_resampleBuffer.size()), getResampleRatio());
+        m_audioStream.push(m_resampleBuffer.data(), count);
+    }
+    else
+    {
+        m_audioStream.push(m_audioBuffer.data(), samplesPerFrame);
+    }
+
+    if (m_recorder.isRecording())
+    {
+        m_recorder.pushFrame(m_board.getVRAM(), m_audioBuffer.data(), samplesPerFrame);
+    }
+}
+
+void Machine::updateRunAhead()
+{
+    SPIN_TRACE_SCOPE("Run ahead");
+    //emulate ahead with the current input and show the result, then
+    //rewind. This hides the frames the ROM takes to respond to input
+    m_board.saveState(m_runAheadState);
+    m_speculating = true;
+
+    //speculative frames are discarded so shouldn't be profiled,
+    //but native routines and fused runs give the same results faster
+    auto& processor = m_board.getProcessor();
+    const auto features = processor.getFeatures();
+    processor.setFeatures(features & (I8080::CPU::HighLevel | I8080::CPU::Fusion));
+
+    for (auto i = 1u; i <= m_options.runAheadFrames; ++i)
+    {
+        m_presenting = (i == m_options.runAheadFrames);
+        m_board.update();
+    }
+
+    processor.setFeatures(features);
+    m_speculating = false;
+    m_board.loadState(m_runAheadState);
+}
+
+double Machine::getResampleRatio()
+{
+    //dynamic rate control: rather than let the host and audio
+    //clocks drift apart, produce slightly more audio when the
+    //stream's buffer is below target and slightly less above it
+    const auto fill = static_cast<double>(m_audioStream.getQueuedCount());
+    m_averageFill += (fill - m_averageFill) * fillSmoothing;
+
+    auto error = (static_cast<double>(targetFill) - m_averageFill) / targetFill;
+    error = std::min(std::max(error, -1.0), 1.0);
+    return 1.0 + error * maxRateDeviation;
 }
 
 void Machine::handleEvent(const sf::Event& evt)
 {
-    if (evt.type == sf::Event::KeyPressed)
+    if (evt.type == sf::Event::KeyPressed
+        || evt.type == sf::Event::KeyReleased)
     {
-        switch (evt.key.code)
+        //the polling thread owns the inputs when it's running
+        if (!m_options.inputThread)
         {
-        default: break;
-        case sf::Keyboard::Num0:
-            //coin insert
-            setFlag(1, 0);
-            break;
-        case sf::Keyboard::Num1:
-            //player 2 start
-            setFlag(1, 2);
-            break;
-        case sf::Keyboard::Num2:
-            //player 1 start
-            setFlag(1, 1);
-            break;
-        case sf::Keyboard::Space:
-            //player 1 shoot
-            setFlag(1, 4);
-            break;
-        case sf::Keyboard::A:
-            //player 1 left
-            setFlag(1, 5);
-            break;
-        case sf::Keyboard::D:
-            //player 1 right
-            setFlag(1, 6);
-            break;
-        case sf::Keyboard::RControl:
-            //player 2 shoot
-            setFlag(2, 4);
-            break;
-        case sf::Keyboard::Left:
-            //player 2 left
-            setFlag(2, 5);
-            break;
-        case sf::Keyboard::Right:
-            //player 2 right
-            setFlag(2, 6);
-            break;
+            const bool pressed = (evt.type == sf::Event::KeyPressed);
+            for (const auto& mapping : m_keyMappings)
+            {
+                if (mapping.key == evt.key.code)
+                {
+                    m_inputState.set(mapping.port, mapping.bit, pressed);
+                }
+            }
+        }
+
+        for (const auto& mapping : m_keyMappings)
+        {
+            if (mapping.key == evt.key.code)
+            {
+                m_latencyTracker.inputArrived(mapping.port, mapping.bit, evt.type == sf::Event::KeyPressed);
+                break;
+            }
         }
     }
-    else if (evt.type == sf::Event::KeyReleased)
+    else if (evt.type == sf::Event::GainedFocus)
+    {
+        m_inputPoller.setEnabled(true);
+    }
+    else if (evt.type == sf::Event::LostFocus)
+    {
+        m_inputPoller.setEnabled(false);
+    }
+
+    if (evt.type == sf::Event::KeyReleased)
     {
         switch (evt.key.code)
         {
         default:break;
         case sf::Keyboard::F1:
-            loadGame(Game::SpaceInvaders);
-            break;
-        case sf::Keyboard::F2:
-            loadGame(Game::BalloonBomber);
-            break;
-        case sf::Keyboard::F3:
-            loadGame(Game::LunarRescue);
+            loadGame("invaders");
             break;
         case sf::Keyboard::Escape:
             m_renderWindow.close();
             break;
-            /*case sf::Keyboard::Space:
-            m_processor.update(1);
-            break;
-            case sf::Keyboard::Z:
-            m_processor.update(500);
+        case sf::Keyboard::Tab:
+            m_turbo = !m_turbo;
             break;
-            case sf::Keyboard::X:
-            m_processor.update(1000);
+        case sf::Keyboard::F9:
+            m_showLatency = !m_showLatency;
             break;
-            case sf::Keyboard::C:
-            m_processor.update(5000);
-            break;*/
-        case sf::Keyboard::Num0:
-            unsetFlag(1, 0);
+        case sf::Keyboard::F10:
+            m_perfHud.setVisible(!m_perfHud.isVisible());
             break;
-        case sf::Keyboard::Num1:
-            unsetFlag(1, 2);
-            break;
-        case sf::Keyboard::Num2:
-            unsetFlag(1, 1);
-            break;
-        case sf::Keyboard::Space:
-            //player 1 shoot
-            unsetFlag(1, 4);
+        case sf::Keyboard::F11:
+            if (Trace::dump(m_options.tracePath))
+            {
+                std::cout << "Wrote trace to " << m_options.tracePath << std::endl;
+            }
             break;
-        case sf::Keyboard::A:
-            //player 1 left
-            unsetFlag(1, 5);
+        case sf::Keyboard::F12:
+            //coverage is collected while the heatmap is shown, which disables
+            //hooks and fusion, so the previous features are put back after.
+            //Coverage asked for on the command line stays on as it's in the mask
+            m_showHeatmap = !m_showHeatmap;
+            if (m_showHeatmap)
+            {
+                m_featuresBeforeHeatmap = m_board.getProcessor().getFeatures();
+                m_board.getProcessor().setFeatures(m_featuresBeforeHeatmap | I8080::CPU::Coverage);
+                updateHeatmap();
+            }
+            else
+            {
+                m_board.getProcessor().setFeatures(m_featuresBeforeHeatmap);
+            }
             break;
-        case sf::Keyboard::D:
-            //player 1 right
-            unsetFlag(1, 6);
+        case sf::Keyboard::F5:
+            if (m_board.getProcessor().getDebugger().isStopped())
+            {
+                m_board.getProcessor().getDebugger().resume();
+            }
+            else
+            {
+                m_board.getProcessor().getDebugger().breakNow();
+            }
             break;
-        case sf::Keyboard::LControl:
-            //player 2 shoot
-            unsetFlag(2, 4);
+        case sf::Keyboard::F6:
+            m_board.getProcessor().getDebugger().stepInto();
             break;
-        case sf::Keyboard::Left:
-            //player 2 left
-            unsetFlag(2, 5);
+        case sf::Keyboard::F7:
+            m_board.getProcessor().getDebugger().stepOver();
             break;
-        case sf::Keyboard::Right:
-            //player 2 right
-            unsetFlag(2, 6);
+        case sf::Keyboard::F8:
+            m_board.getProcessor().getDebugger().stepOut();
             break;
         }
     }
 }
 
-void Machine::draw()
+void Machine::updateHeatmap()
 {
-    m_renderWindow.clear(/*sf::Color::Blue*/);
-    m_renderWindow.draw(m_display);
-    m_renderWindow.draw(m_infoText);
-    m_renderWindow.draw(m_instructionText);
-    m_renderWindow.display();
+    m_board.getProcessor().getCoverage().getHeatmap(m_heatmapPixels);
+    m_heatmapTexture.update(m_heatmapPixels.data());
 }
 
-void Machine::setFlag(std::size_t port, Byte flag)
+void Machine::draw()
 {
-    assert(flag < 8);
-    m_ports[port] |= (1 << flag);
-}
+    {
+        SPIN_TRACE_SCOPE("Machine::draw");
+        m_renderWindow.clear(/*sf::Color::Blue*/);
+        m_renderWindow.draw(m_display);
+        if (m_showHeatmap)
+        {
+            if (m_board.getFrameCount() % heatmapInterval == 0)
+            {
+                updateHeatmap();
+            }
+            m_renderWindow.draw(m_heatmapSprite);
+        }
+        m_renderWindow.draw(m_perfHud);
+        m_renderWindow.draw(m_instructionText);
+        if (m_showLatency)
+        {
+            m_renderWindow.draw(m_latencyText);
+        }
+    }
+    {
+        SPIN_TRACE_SCOPE("display");
+        m_renderWindow.display();
+    }
 
-void Machine::unsetFlag(std::size_t port, Byte flag)
-{
-    assert(flag < 8);
-    m_ports[port] &= ~(1 << flag);
-}
\ No newline at end of file
+    m_perfHud.update(m_audioStream.getQueuedCount());
+
+    //only rebuild the text when there's a new measurement
+    m_latencyTracker.presented();
+    if (m_latencyTracker.getSampleCount() != m_latencySampleCount)
+    {
+        m_latencySampleCount = m_latencyTracker.getSampleCount();
+        m_latencyText.setString(m_latencyTracker.getSummary());
+    }
+}
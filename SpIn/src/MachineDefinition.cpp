@@ -0,0 +1,291 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <MachineDefinition.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    const std::string definitionDirectory("assets/machines/");
+    const std::string definitionExtension(".txt");
+
+    //overlay regions are in unrotated screen coordinates
+    const std::uint32_t screenWidth = 256u;
+    const std::uint32_t screenHeight = 224u;
+
+    //reads a decimal or 0x prefixed hex number, which must be below the given limit
+    bool readNumber(std::istream& stream, std::uint32_t limit, std::uint32_t& dst)
+    {
+        std::string str;
+        if (!(stream >> str)) return false;
+
+        try
+        {
+            std::size_t length = 0;
+            auto value = std::stoul(str, &length, 0);
+            dst = static_cast<std::uint32_t>(value);
+            return (length == str.size() && value < limit);
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+
+    bool readChecksum(std::istream& stream, std::uint32_t& dst)
+    {
+        std::string str;
+        if (!(stream >> str)
+            || str.size() > 8
+            || str.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos)
+        {
+            return false;
+        }
+        dst = static_cast<std::uint32_t>(std::stoul(str, nullptr, 16));
+        return true;
+    }
+}
+
+MachineDefinition::MachineDefinition()
+{
+    clear();
+}
+
+//public
+bool MachineDefinition::loadFromFile(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file.good())
+    {
+        clear();
+        std::cout << "Failed opening machine definition " << path << std::endl;
+        return false;
+    }
+    return loadFromStream(file, path);
+}
+
+bool MachineDefinition::loadFromStream(std::istream& file, const std::string& path)
+{
+    clear();
+
+    std::array<bool, 2u> scheduled = {};
+    std::string line;
+    std::size_t lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream ss(line);
+        std::string command;
+        if (!(ss >> command)) continue;
+
+        bool valid = false;
+        std::uint32_t port = 0;
+        std::uint32_t bit = 0;
+        if (command == "name")
+        {
+            valid = static_cast<bool>(std::getline(ss >> std::ws, m_name));
+            m_name.erase(m_name.find_last_not_of(" \t\r") + 1);
+        }
+        else if (command == "rom")
+        {
+            Rom rom;
+            std::uint32_t address = 0;
+            if (ss >> rom.path && readNumber(ss, 0x10000, address))
+            {
+                rom.address = static_cast<Word>(address);
+
+                //the checksum is optional, but must be valid if given
+                rom.hasChecksum = !(ss >> std::ws).eof();
+                valid = (!rom.hasChecksum || readChecksum(ss, rom.checksum));
+                m_roms.push_back(rom);
+            }
+        }
+        else if (command == "in" && readNumber(ss, I8080::PORT_COUNT, port))
+        {
+            std::string device;
+            ss >> device;
+            valid = true;
+            if (device == "controls")
+            {
+                m_inputDevices[port] = InputDevice::Controls;
+            }
+            else if (device == "shift-result")
+            {
+                m_inputDevices[port] = InputDevice::ShiftResult;
+            }
+            else
+            {
+                valid = false;
+            }
+        }
+        else if (command == "out" && readNumber(ss, I8080::PORT_COUNT, port))
+        {
+            std::string device;
+            ss >> device;
+            valid = true;
+            if (device == "shift-data")
+            {
+                m_outputDevices[port] = OutputDevice::ShiftData;
+            }
+            else if (device == "shift-offset")
+            {
+                m_outputDevices[port] = OutputDevice::ShiftOffset;
+            }
+            else
+            {
+                valid = false;
+            }
+        }
+        else if (command == "sound"
+            && readNumber(ss, I8080::PORT_COUNT, port)
+            && readNumber(ss, 8, bit))
+        {
+            std::string name;
+            ss >> name;
+            for (const auto& file : Sound::files)
+            {
+                if (name == file.name)
+                {
+                    //the port latches its bits whether or not they're all wired
+                    m_outputDevices[port] = OutputDevice::Sound;
+                    m_sounds[port][bit] = file.id;
+                    valid = true;
+                    break;
+                }
+            }
+        }
+        else if (command == "input")
+        {
+            Input input;
+            if (ss >> input.name
+                && readNumber(ss, I8080::PORT_COUNT, port)
+                && readNumber(ss, 8, bit))
+            {
+                input.port = port;
+                input.bit = static_cast<Byte>(bit);
+                m_inputs.push_back(input);
+                valid = true;
+            }
+        }
+        else if (command == "overlay")
+        {
+            std::array<std::uint32_t, 7u> values = {};
+            valid = readNumber(ss, screenWidth, values[0])
+                && readNumber(ss, screenHeight, values[1])
+                && readNumber(ss, screenWidth - values[0] + 1, values[2])
+                && readNumber(ss, screenHeight - values[1] + 1, values[3])
+                && readNumber(ss, 256, values[4])
+                && readNumber(ss, 256, values[5])
+                && readNumber(ss, 256, values[6]);
+
+            if (valid)
+            {
+                Overlay::Region region;
+                region.x = static_cast<std::uint16_t>(values[0]);
+                region.y = static_cast<std::uint16_t>(values[1]);
+                region.width = static_cast<std::uint16_t>(values[2]);
+                region.height = static_cast<std::uint16_t>(values[3]);
+                region.r = static_cast<std::uint8_t>(values[4]);
+                region.g = static_cast<std::uint8_t>(values[5]);
+                region.b = static_cast<std::uint8_t>(values[6]);
+                m_overlay.push_back(region);
+            }
+        }
+        else if (command == "interrupt")
+        {
+            std::string half;
+            ss >> half;
+            const std::size_t index = (half == "top") ? 0 : 1;
+
+            std::uint32_t cycle = 0;
+            std::uint32_t rst = 0;
+            if ((half == "top" || half == "bottom")
+                && readNumber(ss, 0x80000000, cycle)
+                && readNumber(ss, 8, rst))
+            {
+                m_schedule[index].cycle = static_cast<std::int32_t>(cycle);
+                m_schedule[index].rst = static_cast<Byte>(rst);
+                scheduled[index] = true;
+                valid = true;
+            }
+        }
+
+        if (!valid)
+        {
+            std::cout << path << ":" << lineNumber << ": invalid entry" << std::endl;
+            clear();
+            return false;
+        }
+    }
+
+    //the top half is always emulated first
+    if (!scheduled[0] || !scheduled[1]
+        || m_schedule[0].cycle <= 0
+        || m_schedule[0].cycle >= m_schedule[1].cycle)
+    {
+        std::cout << path << ": needs a top and a bottom interrupt, in scan order" << std::endl;
+        clear();
+        return false;
+    }
+
+    return true;
+}
+
+std::string MachineDefinition::getPath(const std::string& name)
+{
+    return definitionDirectory + name + definitionExtension;
+}
+
+const MachineDefinition::Input* MachineDefinition::findInput(const std::string& name) const
+{
+    for (const auto& input : m_inputs)
+    {
+        if (input.name == name)
+        {
+            return &input;
+        }
+    }
+    return nullptr;
+}
+
+//private
+void MachineDefinition::clear()
+{
+    m_name.clear();
+    m_roms.clear();
+    m_inputs.clear();
+    m_overlay.clear();
+    m_schedule = {};
+
+    m_inputDevices.fill(InputDevice::None);
+    m_outputDevices.fill(OutputDevice::None);
+    for (auto& sounds : m_sounds)
+    {
+        sounds.fill(-1);
+    }
+}
\ No newline at end of file
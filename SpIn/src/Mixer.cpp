@@ -0,0 +1,200 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <Mixer.hpp>
+
+#include <SFML/Audio/InputSoundFile.hpp>
+
+#include <algorithm>
+#include <limits>
+
+constexpr std::uint32_t Mixer::SampleRate;
+constexpr std::size_t Mixer::ChannelCount;
+constexpr std::size_t Mixer::MaxEvents;
+
+namespace
+{
+    const std::int32_t volume = 60;
+}
+
+Mixer::Mixer()
+    : m_eventCount  (0),
+    m_source        (Source::Synth),
+    m_synth         (SampleRate)
+{
+
+}
+
+//public
+bool Mixer::loadSamples()
+{
+    bool loaded = false;
+    for (const auto& file : Sound::files)
+    {
+        if (file.id < 0 || static_cast<std::size_t>(file.id) >= ChannelCount) continue;
+
+        sf::InputSoundFile soundFile;
+        if (!soundFile.openFromFile(file.path)) continue;
+
+        const auto channels = soundFile.getChannelCount();
+        std::vector<std::int16_t> interleaved(static_cast<std::size_t>(soundFile.getSampleCount()));
+        interleaved.resize(static_cast<std::size_t>(soundFile.read(interleaved.data(), interleaved.size())));
+
+        //everything is mixed in mono
+        auto& sample = m_samples[file.id];
+        sample.loop = file.loop;
+        sample.data.resize(interleaved.size() / channels);
+        for (auto i = 0u; i < sample.data.size(); ++i)
+        {
+            std::int32_t sum = 0;
+            for (auto j = 0u; j < channels; ++j)
+            {
+                sum += interleaved[i * channels + j];
+            }
+            sample.data[i] = static_cast<std::int16_t>(sum / static_cast<std::int32_t>(channels));
+        }
+        loaded = loaded || !sample.data.empty();
+    }
+    return loaded;
+}
+
+void Mixer::queueEvent(Sound::ID id, bool start, std::uint32_t offset)
+{
+    if (id < 0 || static_cast<std::size_t>(id) >= ChannelCount
+        || (m_source == Source::Samples && m_samples[id].data.empty()))
+    {
+        return;
+    }
+
+    //the CPU can't write the ports often enough in
+    //one block to fill the queue, so just drop if it does
+    if (m_eventCount == MaxEvents) return;
+
+    //keep the queue in order so it can be applied in one pass
+    if (m_eventCount > 0)
+    {
+        offset = std::max(offset, m_events[m_eventCount - 1].offset);
+    }
+
+    auto& evt = m_events[m_eventCount++];
+    evt.id = id;
+    evt.start = start;
+    evt.offset = offset;
+}
+
+void Mixer::reset()
+{
+    for (auto& voice : m_voices)
+    {
+        voice.playing = false;
+        voice.position = 0;
+    }
+    m_eventCount = 0;
+    m_synth.reset();
+}
+
+void Mixer::mix(std::int16_t* output, std::uint32_t count)
+{
+    if (m_mixBuffer.size() < count)
+    {
+        m_mixBuffer.resize(count);
+    }
+    std::fill_n(m_mixBuffer.begin(), count, 0);
+
+    //render up to each event in turn so sounds start
+    //and stop on the sample at which they were queued
+    std::uint32_t position = 0;
+    for (auto i = 0u; i < m_eventCount; ++i)
+    {
+        const auto offset = std::min(m_events[i].offset, count);
+        render(position, offset);
+        position = offset;
+
+        applyEvent(m_events[i]);
+    }
+    render(position, count);
+    m_eventCount = 0;
+
+    for (auto i = 0u; i < count; ++i)
+    {
+        auto sample = (m_mixBuffer[i] * volume) / 100;
+        sample = std::min(std::max(sample, static_cast<std::int32_t>(std::numeric_limits<std::int16_t>::min())),
+                            static_cast<std::int32_t>(std::numeric_limits<std::int16_t>::max()));
+        output[i] = static_cast<std::int16_t>(sample);
+    }
+}
+
+//private
+void Mixer::applyEvent(const Event& evt)
+{
+    if (m_source == Source::Synth)
+    {
+        m_synth.setGate(evt.id, evt.start);
+        return;
+    }
+
+    auto& voice = m_voices[evt.id];
+    if (evt.start)
+    {
+        voice.playing = true;
+        voice.position = 0;
+    }
+    else if (m_samples[evt.id].loop)
+    {
+        voice.playing = false;
+    }
+}
+
+void Mixer::render(std::uint32_t start, std::uint32_t end)
+{
+    if (m_source == Source::Synth)
+    {
+        m_synth.render(&m_mixBuffer[start], end - start);
+        return;
+    }
+
+    for (auto i = 0u; i < ChannelCount; ++i)
+    {
+        auto& voice = m_voices[i];
+        if (!voice.playing) continue;
+
+        const auto& sample = m_samples[i];
+        auto output = start;
+        while (output < end && voice.playing)
+        {
+            const auto length = std::min(static_cast<std::size_t>(end - output), sample.data.size() - voice.position);
+            for (auto j = 0u; j < length; ++j)
+            {
+                m_mixBuffer[output + j] += sample.data[voice.position + j];
+            }
+            output += static_cast<std::uint32_t>(length);
+            voice.position += length;
+
+            if (voice.position == sample.data.size())
+            {
+                voice.position = 0;
+                voice.playing = sample.loop;
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,365 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <Options.hpp>
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+    const std::uint32_t maxRunAheadFrames = 4u;
+
+    bool parseNumber(const std::string& str, std::uint32_t& dst)
+    {
+        try
+        {
+            auto value = std::stoul(str);
+            dst = static_cast<std::uint32_t>(value);
+            return true;
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+
+    bool parseHex(const std::string& str, std::uint32_t& dst)
+    {
+        if (str.empty() || str.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos)
+        {
+            return false;
+        }
+        dst = static_cast<std::uint32_t>(std::stoul(str, nullptr, 16));
+        return true;
+    }
+
+    bool parseAddress(const std::string& str, Word& dst)
+    {
+        std::uint32_t value = 0;
+        if (!parseHex(str, value) || value > 0xFFFF) return false;
+
+        dst = static_cast<Word>(value);
+        return true;
+    }
+
+    //ADDR[+LENGTH][:r|w|rw][=VALUE|!VALUE|~]
+    bool parseWatchpoint(std::string str, I8080::Debugger::Watchpoint& dst)
+    {
+        using Condition = I8080::Debugger::Condition;
+
+        const auto conditionPos = str.find_first_of("=!~");
+        if (conditionPos != std::string::npos)
+        {
+            const auto condition = str.substr(conditionPos);
+            str = str.substr(0, conditionPos);
+
+            std::uint32_t value = 0;
+            if (condition == "~")
+            {
+                dst.condition = Condition::Changed;
+            }
+            else if (parseHex(condition.substr(1), value) && value <= 0xFF)
+            {
+                dst.condition = (condition[0] == '=') ? Condition::Equal : Condition::NotEqual;
+                dst.value = static_cast<Byte>(value);
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        const auto accessPos = str.find(':');
+        if (accessPos != std::string::npos)
+        {
+            const auto access = str.substr(accessPos + 1);
+            str = str.substr(0, accessPos);
+
+            if (access != "r" && access != "w" && access != "rw") return false;
+            dst.read = (access.find('r') != std::string::npos);
+            dst.write = (access.find('w') != std::string::npos);
+        }
+
+        const auto lengthPos = str.find('+');
+        if (lengthPos != std::string::npos)
+        {
+            if (!parseAddress(str.substr(lengthPos + 1), dst.length) || dst.length == 0) return false;
+            str = str.substr(0, lengthPos);
+        }
+        return parseAddress(str, dst.address);
+    }
+}
+
+bool Options::parse(int argc, char** argv)
+{
+    for (auto i = 1; i < argc; ++i)
+    {
+        const std::string arg(argv[i]);
+        const bool hasValue = (i + 1 < argc);
+
+        if (arg == "--help" || arg == "-h")
+        {
+            showHelp = true;
+        }
+        else if (arg == "--headless")
+        {
+            headless = true;
+        }
+        else if (arg == "--game" && hasValue)
+        {
+            game = argv[++i];
+            hasGame = true;
+        }
+        else if (arg == "--frames" && hasValue)
+        {
+            if (!parseNumber(argv[++i], frameCount)) return false;
+        }
+        else if (arg == "--sound" && hasValue)
+        {
+            const std::string source(argv[++i]);
+            if (source == "synth")
+            {
+                soundSource = Mixer::Source::Synth;
+            }
+            else if (source == "samples")
+            {
+                soundSource = Mixer::Source::Samples;
+            }
+            else
+            {
+                std::cout << "Unknown sound source " << source << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--pacing" && hasValue)
+        {
+            const std::string mode(argv[++i]);
+            if (mode == "audio")
+            {
+                pacing = Pacing::Audio;
+            }
+            else if (mode == "clock")
+            {
+                pacing = Pacing::Clock;
+            }
+            else
+            {
+                std::cout << "Unknown pacing mode " << mode << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--turbo-skip" && hasValue)
+        {
+            if (!parseNumber(argv[++i], turboFrameSkip) || turboFrameSkip == 0) return false;
+        }
+        else if (arg == "--turbo-audio")
+        {
+            turboAudio = true;
+        }
+        else if (arg == "--input-thread")
+        {
+            inputThread = true;
+        }
+        else if (arg == "--hle")
+        {
+            highLevel = true;
+        }
+        else if (arg == "--no-fusion")
+        {
+            fusion = false;
+        }
+        else if (arg == "--opcode-stats" && hasValue)
+        {
+            opcodeStatsPath = argv[++i];
+        }
+        else if (arg == "--sequence-stats" && hasValue)
+        {
+            sequenceStatsPath = argv[++i];
+        }
+        else if (arg == "--call-graph" && hasValue)
+        {
+            callGraphPath = argv[++i];
+        }
+        else if (arg == "--routine-stats" && hasValue)
+        {
+            routineStatsPath = argv[++i];
+        }
+        else if (arg == "--symbols" && hasValue)
+        {
+            symbolsPath = argv[++i];
+        }
+        else if (arg == "--instruction-trace" && hasValue)
+        {
+            instructionTracePath = argv[++i];
+        }
+        else if (arg == "--coverage" && hasValue)
+        {
+            coveragePath = argv[++i];
+        }
+        else if (arg == "--heatmap" && hasValue)
+        {
+            heatmapPath = argv[++i];
+        }
+        else if (arg == "--break" && hasValue)
+        {
+            Word address = 0;
+            if (!parseAddress(argv[++i], address)) return false;
+            breakpoints.push_back(address);
+        }
+        else if (arg == "--watch" && hasValue)
+        {
+            I8080::Debugger::Watchpoint watchpoint;
+            if (!parseWatchpoint(argv[++i], watchpoint)) return false;
+            watchpoints.push_back(watchpoint);
+        }
+        else if (arg == "--trace-file" && hasValue)
+        {
+            tracePath = argv[++i];
+        }
+        else if (arg == "--latency-log" && hasValue)
+        {
+            latencyLogPath = argv[++i];
+        }
+        else if (arg == "--run-ahead" && hasValue)
+        {
+            if (!parseNumber(argv[++i], runAheadFrames) || runAheadFrames > maxRunAheadFrames) return false;
+        }
+        else if (arg == "--record-video" && hasValue)
+        {
+            recording.videoPath = argv[++i];
+        }
+        else if (arg == "--video-format" && hasValue)
+        {
+            const std::string format(argv[++i]);
+            if (format == "raw")
+            {
+                recording.videoFormat = Recorder::VideoFormat::Raw;
+            }
+            else if (format == "y4m")
+            {
+                recording.videoFormat = Recorder::VideoFormat::Y4M;
+            }
+            else
+            {
+                std::cout << "Unknown video format " << format << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--video-scale" && hasValue)
+        {
+            if (!parseNumber(argv[++i], recording.videoScale)) return false;
+        }
+        else if (arg == "--record-audio" && hasValue)
+        {
+            recording.audioPath = argv[++i];
+        }
+        else
+        {
+            std::cout << "Invalid argument " << arg << std::endl;
+            return false;
+        }
+    }
+
+    //there's no need to drop frames when not running in real time
+    recording.lossless = headless;
+
+    if (headless && !hasGame)
+    {
+        std::cout << "--headless requires --game" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+std::uint32_t Options::getProcessorFeatures() const
+{
+    std::uint32_t features = 0;
+    if (!opcodeStatsPath.empty() || !sequenceStatsPath.empty())
+    {
+        features |= I8080::CPU::Profiling;
+    }
+    if (!callGraphPath.empty() || !routineStatsPath.empty())
+    {
+        features |= I8080::CPU::CallProfiling;
+    }
+    if (!instructionTracePath.empty())
+    {
+        features |= I8080::CPU::InstructionTracing;
+    }
+    if (!coveragePath.empty() || !heatmapPath.empty())
+    {
+        features |= I8080::CPU::Coverage;
+    }
+    if (highLevel)
+    {
+        features |= I8080::CPU::HighLevel;
+    }
+    if (fusion)
+    {
+        features |= I8080::CPU::Fusion;
+    }
+    return features;
+}
+
+void Options::printUsage()
+{
+    std::cout <<
+        "Usage: spin [options]\n"
+        "  --game <name>            Load assets/machines/<name>.txt at start, eg invaders\n"
+        "  --headless               Run without a window or audio device, uncapped\n"
+        "  --frames <count>         Number of frames to run when headless (default 3600)\n"
+        "  --sound <source>         synth (default) or samples from assets/sounds\n"
+        "  --pacing <mode>          audio (default) or clock\n"
+        "  --turbo-skip <frames>    Display every Nth frame when fast forwarding (default 8)\n"
+        "  --turbo-audio            Keep audio playing when fast forwarding\n"
+        "  --input-thread           Poll the keyboard on its own thread at 1kHz\n"
+        "  --hle                    Run known Space Invaders sprite and copy routines natively.\n"
+        "                           Disabled while profiling, tracing, debugging or measuring coverage\n"
+        "  --no-fusion              Dispatch every instruction on its own. Common runs of instructions\n"
+        "                           are otherwise dispatched as one, except while profiling, tracing,\n"
+        "                           debugging or measuring coverage\n"
+        "  --opcode-stats <path>    Count executions, cycles and branches per opcode, written as CSV on exit\n"
+        "  --sequence-stats <path>  Count pairs and triples of instructions run in sequence, written as CSV\n"
+        "                           on exit. These are the candidates for fusion\n"
+        "  --call-graph <path>      Attribute cycles to guest routines, written as folded stacks on exit\n"
+        "  --routine-stats <path>   Attribute cycles to guest routines, written as CSV on exit\n"
+        "  --symbols <path>         Label file used to name guest routines\n"
+        "  --instruction-trace <path>\n"
+        "                           Write every executed instruction to a binary trace, compare\n"
+        "                           two traces with spin_tracediff\n"
+        "  --coverage <path>        Write the coverage of each ROM chip and RAM region as CSV on exit\n"
+        "  --heatmap <path>         Save an image of executed, read and written memory on exit\n"
+        "  --break <addr>           Stop the CPU at the given hex address, may be repeated\n"
+        "  --watch <spec>           Stop the CPU on a memory access, may be repeated. The spec is\n"
+        "                           addr[+length][:r|w|rw][=value|!value|~], hex, ~ for changes\n"
+        "  --trace-file <path>      Where F11 writes the timeline in tracing builds (default trace.json)\n"
+        "  --latency-log <path>     Write input latency measurements to a CSV file\n"
+        "  --run-ahead <frames>     Display frames emulated ahead to hide input lag (0 - 4, default 0)\n"
+        "  --record-video <path>    Record each frame to the given file\n"
+        "  --video-format <format>  y4m (composited, default) or raw (VRAM)\n"
+        "  --video-scale <scale>    Scale of composited video (default 1)\n"
+        "  --record-audio <path>    Record audio to the given WAV file\n"
+        "  --help                   Show this message\n";
+}
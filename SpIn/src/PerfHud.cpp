@@ -0,0 +1,147 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <PerfHud.hpp>
+
+#include <SFML/Graphics/RenderTarget.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    //how often the displayed values are recalculated
+    const std::chrono::milliseconds refreshInterval(500);
+}
+
+PerfHud::PerfHud()
+    : m_visible         (true),
+    m_frameTimeCount    (0),
+    m_firstCycles       (0),
+    m_lastCycles        (0),
+    m_firstInstructions (0),
+    m_lastInstructions  (0),
+    m_emulatedFrames    (0),
+    m_hasCounts         (false),
+    m_uploadTime        (Clock::duration::zero()),
+    m_uploadCount       (0)
+{
+    m_frameTimes.fill(0.f);
+    m_string.fill(0);
+    m_lastFrame = m_lastRefresh = Clock::now();
+
+    m_text.setCharacterSize(12u);
+}
+
+//public
+void PerfHud::setFont(const sf::Font& font)
+{
+    m_text.setFont(font);
+}
+
+void PerfHud::addEmulatedFrame(std::uint64_t cycles, std::uint64_t instructions)
+{
+    //the counts start again when a game is loaded
+    if (!m_hasCounts || cycles < m_lastCycles)
+    {
+        m_firstCycles = cycles;
+        m_firstInstructions = instructions;
+        m_emulatedFrames = 0;
+        m_hasCounts = true;
+    }
+    else
+    {
+        m_emulatedFrames++;
+    }
+    m_lastCycles = cycles;
+    m_lastInstructions = instructions;
+}
+
+void PerfHud::addUploadTime(Clock::duration duration)
+{
+    m_uploadTime += duration;
+    m_uploadCount++;
+}
+
+void PerfHud::update(std::size_t audioFill)
+{
+    const auto now = Clock::now();
+    m_frameTimes[m_frameTimeCount++ % m_frameTimes.size()] = std::chrono::duration<float, std::milli>(now - m_lastFrame).count();
+    m_lastFrame = now;
+
+    if (m_visible && now - m_lastRefresh >= refreshInterval)
+    {
+        refresh(now, audioFill);
+    }
+}
+
+//private
+void PerfHud::refresh(Clock::time_point now, std::size_t audioFill)
+{
+    const auto elapsed = std::chrono::duration<double>(now - m_lastRefresh).count();
+    m_lastRefresh = now;
+
+    const auto mhz = (elapsed > 0.0) ? static_cast<double>(m_lastCycles - m_firstCycles) / elapsed / 1000000.0 : 0.0;
+    const auto instructions = (m_emulatedFrames > 0) ? (m_lastInstructions - m_firstInstructions) / m_emulatedFrames : 0u;
+    const auto upload = (m_uploadCount > 0) ? std::chrono::duration<double, std::milli>(m_uploadTime).count() / m_uploadCount : 0.0;
+
+    //percentiles of the recorded frame times
+    const auto count = std::min(m_frameTimeCount, m_frameTimes.size());
+    std::array<float, 128u> sorted;
+    std::copy_n(m_frameTimes.begin(), count, sorted.begin());
+    std::sort(sorted.begin(), sorted.begin() + count);
+    const auto p50 = (count > 0) ? sorted[count / 2] : 0.f;
+    const auto p99 = (count > 0) ? sorted[(count * 99) / 100] : 0.f;
+
+    m_firstCycles = m_lastCycles;
+    m_firstInstructions = m_lastInstructions;
+    m_emulatedFrames = 0;
+    m_uploadTime = Clock::duration::zero();
+    m_uploadCount = 0;
+
+    //formatting into a fixed buffer doesn't allocate, and
+    //glyphs are only laid out again if the values changed
+    std::array<char, 256u> str;
+    std::snprintf(str.data(), str.size(),
+        "Emulated: %.3f MHz\n"
+        "Frame: p50 %.1fms p99 %.1fms\n"
+        "Instructions/frame: %llu\n"
+        "Upload: %.3fms\n"
+        "Audio queued: %u samples",
+        mhz, p50, p99, static_cast<unsigned long long>(instructions), upload, static_cast<unsigned>(audioFill));
+
+    if (std::strcmp(str.data(), m_string.data()) != 0)
+    {
+        m_string = str;
+        m_text.setString(m_string.data());
+    }
+}
+
+void PerfHud::draw(sf::RenderTarget& rt, sf::RenderStates states) const
+{
+    if (m_visible)
+    {
+        rt.draw(m_text, states);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,288 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <Recorder.hpp>
+#include <Compositor.hpp>
+
+#include <SFML/Audio/OutputSoundFile.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+    const std::size_t queueSize = 64u;
+    //more than enough for a frame of audio at any sensible rate
+    const std::uint32_t maxSamplesPerFrame = 4096u;
+    //room in each slot for the audio of frames dropped after it
+    //before it has to grow
+    const std::uint32_t reservedFrames = 4u;
+
+    const std::uint32_t framesPerSecond = 60u;
+    const std::uint32_t sampleRate = 44100u;
+
+    //raw VRAM is stored in its native, unrotated, layout
+    const std::uint16_t rawWidth = 256u;
+    const std::uint16_t rawHeight = 224u;
+    const std::uint32_t rawVersion = 1u;
+
+    template <typename T>
+    void writeLE(std::ofstream& file, T value)
+    {
+        for (auto i = 0u; i < sizeof(T); ++i)
+        {
+            file.put(static_cast<char>((value >> (i * 8)) & 0xFF));
+        }
+    }
+}
+
+Recorder::Recorder()
+    : m_readIndex   (0),
+    m_writeIndex    (0),
+    m_queuedCount   (0),
+    m_recording     (false),
+    m_stopping      (false),
+    m_droppedFrames (0),
+    m_writtenFrames (0)
+{
+
+}
+
+Recorder::~Recorder()
+{
+    stop();
+}
+
+//public
+bool Recorder::start(const Settings& settings)
+{
+    stop();
+
+    if (settings.videoPath.empty() && settings.audioPath.empty())
+    {
+        return false;
+    }
+    m_settings = settings;
+
+    if (!settings.videoPath.empty())
+    {
+        m_videoFile.open(settings.videoPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!m_videoFile.good())
+        {
+            std::cout << "Failed opening video file " << settings.videoPath << std::endl;
+            return false;
+        }
+
+        if (settings.videoFormat == VideoFormat::Raw)
+        {
+            m_videoFile.write("SPINVRAM", 8);
+            writeLE(m_videoFile, rawVersion);
+            writeLE(m_videoFile, rawWidth);
+            writeLE(m_videoFile, rawHeight);
+            writeLE(m_videoFile, framesPerSecond);
+        }
+        else
+        {
+            m_compositor = std::make_unique<Compositor>(settings.overlay, settings.videoScale);
+            m_videoBuffer.resize(m_compositor->getWidth() * m_compositor->getHeight() * 3u);
+
+            m_videoFile << "YUV4MPEG2 W" << m_compositor->getWidth() << " H" << m_compositor->getHeight()
+                << " F" << framesPerSecond << ":1 Ip A1:1 C444\n";
+        }
+    }
+
+    if (!settings.audioPath.empty())
+    {
+        m_audioFile = std::make_unique<sf::OutputSoundFile>();
+        if (!m_audioFile->openFromFile(settings.audioPath, sampleRate, 1))
+        {
+            std::cout << "Failed opening audio file " << settings.audioPath << std::endl;
+            m_audioFile.reset();
+            m_videoFile.close();
+            m_compositor.reset();
+            return false;
+        }
+    }
+
+    //all allocation is done up front so pushing frames never allocates
+    m_frames.resize(queueSize);
+    for (auto& frame : m_frames)
+    {
+        frame.samples.resize(maxSamplesPerFrame * reservedFrames);
+    }
+    m_readIndex = 0;
+    m_writeIndex = 0;
+    m_queuedCount = 0;
+    m_droppedFrames = 0;
+    m_writtenFrames = 0;
+    m_stopping = false;
+    m_recording = true;
+
+    m_thread = std::thread(&Recorder::threadFunc, this);
+    return true;
+}
+
+void Recorder::stop()
+{
+    if (!m_recording) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_frameQueued.notify_one();
+    m_thread.join();
+
+    m_videoFile.close();
+    m_audioFile.reset(); //finalises the WAV header
+    m_compositor.reset();
+    m_recording = false;
+
+    if (m_droppedFrames > 0)
+    {
+        std::cout << "Recording dropped " << m_droppedFrames << " frames" << std::endl;
+    }
+}
+
+void Recorder::pushFrame(const Byte* vram, const std::int16_t* samples, std::uint32_t sampleCount)
+{
+    if (!m_recording) return;
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_queuedCount == m_frames.size())
+        {
+            if (!m_settings.lossless)
+            {
+                //only the video is dropped. The audio is added to the last
+                //queued frame, whose video is written again in place of this
+                //one, so the WAV has no gaps and the two stay in step. The
+                //writer is on the oldest slot while the queue is full, so
+                //the newest can be changed under the lock
+                auto& last = m_frames[(m_writeIndex + m_frames.size() - 1) % m_frames.size()];
+                appendSamples(last, samples, sampleCount);
+                last.repeats++;
+                m_droppedFrames++;
+                return;
+            }
+            m_frameWritten.wait(lock, [this]() {return m_queuedCount < m_frames.size(); });
+        }
+    }
+
+    //the writer thread won't touch this slot until it's been queued
+    auto& frame = m_frames[m_writeIndex];
+    std::copy(vram, vram + I8080::VRAM_SIZE, frame.vram.begin());
+    frame.sampleCount = 0;
+    frame.repeats = 0;
+    appendSamples(frame, samples, sampleCount);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_writeIndex = (m_writeIndex + 1) % m_frames.size();
+        m_queuedCount++;
+    }
+    m_frameQueued.notify_one();
+}
+
+//private
+void Recorder::threadFunc()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_frameQueued.wait(lock, [this]() {return m_queuedCount > 0 || m_stopping; });
+            if (m_queuedCount == 0) return; //stopping and queue is flushed
+        }
+
+        writeFrame(m_frames[m_readIndex]);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_readIndex = (m_readIndex + 1) % m_frames.size();
+            m_queuedCount--;
+        }
+        m_frameWritten.notify_one();
+    }
+}
+
+void Recorder::appendSamples(Frame& frame, const std::int16_t* samples, std::uint32_t sampleCount)
+{
+    sampleCount = std::min(sampleCount, maxSamplesPerFrame);
+
+    //only grows if the writer falls behind by more than the reserved frames
+    if (frame.sampleCount + sampleCount > frame.samples.size())
+    {
+        frame.samples.resize(frame.samples.size() * 2);
+    }
+    std::copy(samples, samples + sampleCount, frame.samples.begin() + frame.sampleCount);
+    frame.sampleCount += sampleCount;
+}
+
+void Recorder::writeFrame(const Frame& frame)
+{
+    if (m_videoFile.is_open())
+    {
+        for (auto i = 0u; i <= frame.repeats; ++i)
+        {
+            writeVideo(frame);
+        }
+    }
+
+    if (m_audioFile && frame.sampleCount > 0)
+    {
+        m_audioFile->write(frame.samples.data(), frame.sampleCount);
+    }
+}
+
+void Recorder::writeVideo(const Frame& frame)
+{
+    if (m_settings.videoFormat == VideoFormat::Raw)
+    {
+        m_videoFile.write(reinterpret_cast<const char*>(frame.vram.data()), frame.vram.size());
+    }
+    else
+    {
+        const auto* rgba = m_compositor->update(frame.vram.data(), static_cast<float>(m_writtenFrames) / framesPerSecond);
+
+        //BT.601 studio swing, written as planar Y, Cb, Cr
+        const auto planeSize = m_compositor->getWidth() * m_compositor->getHeight();
+        auto* y = m_videoBuffer.data();
+        auto* cb = y + planeSize;
+        auto* cr = cb + planeSize;
+        for (auto i = 0u; i < planeSize; ++i)
+        {
+            const std::int32_t r = rgba[i * 4];
+            const std::int32_t g = rgba[i * 4 + 1];
+            const std::int32_t b = rgba[i * 4 + 2];
+
+            y[i] = static_cast<std::uint8_t>(16 + ((66 * r + 129 * g + 25 * b + 128) >> 8));
+            cb[i] = static_cast<std::uint8_t>(128 + ((-38 * r - 74 * g + 112 * b + 128) >> 8));
+            cr[i] = static_cast<std::uint8_t>(128 + ((112 * r - 94 * g - 18 * b + 128) >> 8));
+        }
+
+        m_videoFile << "FRAME\n";
+        m_videoFile.write(reinterpret_cast<const char*>(m_videoBuffer.data()), m_videoBuffer.size());
+    }
+    m_writtenFrames++;
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <Resampler.hpp>
+
+Resampler::Resampler()
+    : m_position    (0.0),
+    m_previous      (0)
+{
+
+}
+
+//public
+std::uint32_t Resampler::process(const std::int16_t* input, std::uint32_t inputCount,
+                                    std::int16_t* output, std::uint32_t maxOutput, double ratio)
+{
+    if (inputCount == 0) return 0;
+
+    //position 0 is the last sample of the previous block,
+    //position n is input[n - 1]
+    const auto step = 1.0 / ratio;
+    std::uint32_t count = 0;
+    while (m_position < inputCount && count < maxOutput)
+    {
+        const auto index = static_cast<std::uint32_t>(m_position);
+        const auto fraction = m_position - index;
+        const double a = (index == 0) ? m_previous : input[index - 1];
+        const double b = input[index];
+        output[count++] = static_cast<std::int16_t>(a + (b - a) * fraction);
+        m_position += step;
+    }
+
+    m_position -= inputCount;
+    if (m_position < 0.0) m_position = 0.0;
+    m_previous = input[inputCount - 1];
+
+    return count;
+}
+
+void Resampler::reset()
+{
+    m_position = 0.0;
+    m_previous = 0;
+}
\ No newline at end of file
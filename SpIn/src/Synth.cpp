@@ -0,0 +1,405 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <Synth.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPIN_SYNTH_SSE
+#include <emmintrin.h>
+#endif
+
+constexpr std::size_t Synth::LaneCount;
+constexpr std::uint32_t Synth::BlockSize;
+
+namespace
+{
+    const float pi = 3.14159265f;
+
+    //envelopes below this are considered silent
+    const float silence = 0.0001f;
+
+    //keeps the state variable filter stable
+    const float maxCutoff = 0.9f;
+
+    //corner of the coupling capacitors in to the amplifier
+    const float couplingFrequency = 20.f;
+
+    enum Circuit
+    {
+        UFO,
+        Shot,
+        ShipHit,
+        InvaderHit,
+        ExtendedPlay,
+        Fleet,
+        MotherShip,
+        Unused
+    };
+
+    //approximations of the component values of each circuit.
+    //times are in seconds and frequencies in Hz
+    struct Patch final
+    {
+        float frequency; //!< VCO frequency with no modulation
+        float duty;
+        float lfoFrequency;
+        float lfoDepth;
+        float sweepTime; //!< RC time constant of the sweep capacitor, 0 for none
+        float sweepDepth;
+        float tone;
+        float noise;
+        float cutoff;
+        float cutoffSweep; //!< added to the cutoff when the sweep capacitor is charged
+        float q;
+        float lowPass;
+        float bandPass;
+        float attackTime;
+        float releaseTime;
+        float gain;
+        bool held;
+    };
+
+    const std::array<Patch, Synth::LaneCount> patches =
+    {{
+        //UFO: 555 VCO warbled by the triangle of a slow 555
+        { 600.f, 0.6f, 6.5f, 0.45f, 0.f, 0.f, 1.f, 0.f, 2500.f, 0.f, 0.7f, 1.f, 0.f, 0.005f, 0.03f, 0.25f, true },
+        //shot: VCO swept down as its capacitor discharges, over band passed noise
+        { 1400.f, 0.5f, 0.f, 0.f, 0.06f, 1.5f, 0.5f, 0.5f, 1500.f, 3000.f, 1.f, 0.5f, 0.8f, 0.f, 0.14f, 0.35f, false },
+        //ship hit: noise through a low pass which closes as the capacitor discharges
+        { 0.f, 0.5f, 0.f, 0.f, 0.35f, 0.f, 0.f, 1.f, 150.f, 1800.f, 1.2f, 1.f, 0.3f, 0.f, 0.9f, 0.9f, false },
+        //invader hit: short swept tone and noise burst
+        { 300.f, 0.5f, 0.f, 0.f, 0.05f, 2.f, 0.4f, 0.8f, 400.f, 2500.f, 1.f, 0.7f, 0.7f, 0.f, 0.18f, 0.6f, false },
+        //extended play: fixed 555 tone, held for as long as the bit is set
+        { 480.f, 0.5f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 3000.f, 0.f, 0.7f, 1.f, 0.f, 0.003f, 0.02f, 0.2f, true },
+        //fleet: four tone generators share the lane as only one sounds at a time.
+        //a narrow pulse through a low pass gives each note its thump
+        { 62.f, 0.3f, 0.f, 0.f, 0.03f, 0.3f, 1.f, 0.f, 180.f, 0.f, 0.8f, 1.f, 0.f, 0.f, 0.1f, 1.2f, false },
+        //mothership hit: warbling VCO swept down over a little noise
+        { 350.f, 0.5f, 14.f, 0.5f, 0.6f, 1.f, 0.8f, 0.2f, 1200.f, 1500.f, 1.f, 1.f, 0.2f, 0.f, 0.8f, 0.4f, false },
+        { 0.f, 0.5f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.01f, 0.f, false }
+    }};
+
+    std::int32_t getCircuit(Sound::ID id)
+    {
+        switch (id)
+        {
+        default: return -1;
+        case Sound::UFO: return UFO;
+        case Sound::Shot: return Shot;
+        case Sound::ShipHit: return ShipHit;
+        case Sound::InvaderHit: return InvaderHit;
+        case Sound::ExtendedPlay: return ExtendedPlay;
+        case Sound::Invader0:
+        case Sound::Invader1:
+        case Sound::Invader2:
+        case Sound::Invader3:
+            return Fleet;
+        case Sound::MotherShip: return MotherShip;
+        }
+    }
+
+    //coefficient of the state variable filter for the given frequency
+    float getCutoff(float frequency, float sampleRate)
+    {
+        return std::min(2.f * std::sin(pi * std::min(frequency, sampleRate / 6.f) / sampleRate), maxCutoff);
+    }
+
+    //four lanes processed at once, with SSE where the target has it
+    struct Quad final
+    {
+#ifdef SPIN_SYNTH_SSE
+        __m128 v;
+
+        static Quad load(const float* src) { return { _mm_load_ps(src) }; }
+        static Quad set(float f) { return { _mm_set1_ps(f) }; }
+        void store(float* dst) const { _mm_store_ps(dst, v); }
+#else
+        std::array<float, 4u> v;
+
+        static Quad load(const float* src) { return { { { src[0], src[1], src[2], src[3] } } }; }
+        static Quad set(float f) { return { { { f, f, f, f } } }; }
+        void store(float* dst) const { std::copy(v.begin(), v.end(), dst); }
+#endif
+    };
+
+#ifdef SPIN_SYNTH_SSE
+    Quad operator + (Quad a, Quad b) { return { _mm_add_ps(a.v, b.v) }; }
+    Quad operator - (Quad a, Quad b) { return { _mm_sub_ps(a.v, b.v) }; }
+    Quad operator * (Quad a, Quad b) { return { _mm_mul_ps(a.v, b.v) }; }
+    Quad minimum(Quad a, Quad b) { return { _mm_min_ps(a.v, b.v) }; }
+    Quad maximum(Quad a, Quad b) { return { _mm_max_ps(a.v, b.v) }; }
+    Quad absolute(Quad a) { return { _mm_andnot_ps(_mm_set1_ps(-0.f), a.v) }; }
+
+    //a < b ? x : y
+    Quad lessSelect(Quad a, Quad b, Quad x, Quad y)
+    {
+        const auto mask = _mm_cmplt_ps(a.v, b.v);
+        return { _mm_or_ps(_mm_and_ps(mask, x.v), _mm_andnot_ps(mask, y.v)) };
+    }
+#else
+    //the same operations one lane at a time, which
+    //the compiler may still vectorise for other targets
+#define SPIN_QUAD_OP(signature, expression)\
+    signature\
+    {\
+        Quad result;\
+        for (auto i = 0u; i < 4u; ++i)\
+        {\
+            result.v[i] = expression;\
+        }\
+        return result;\
+    }
+
+    SPIN_QUAD_OP(Quad operator + (Quad a, Quad b), a.v[i] + b.v[i])
+    SPIN_QUAD_OP(Quad operator - (Quad a, Quad b), a.v[i] - b.v[i])
+    SPIN_QUAD_OP(Quad operator * (Quad a, Quad b), a.v[i] * b.v[i])
+    SPIN_QUAD_OP(Quad minimum(Quad a, Quad b), std::min(a.v[i], b.v[i]))
+    SPIN_QUAD_OP(Quad maximum(Quad a, Quad b), std::max(a.v[i], b.v[i]))
+    SPIN_QUAD_OP(Quad absolute(Quad a), std::abs(a.v[i]))
+
+    //a < b ? x : y
+    SPIN_QUAD_OP(Quad lessSelect(Quad a, Quad b, Quad x, Quad y), (a.v[i] < b.v[i]) ? x.v[i] : y.v[i])
+#undef SPIN_QUAD_OP
+#endif
+}
+
+Synth::Synth(std::uint32_t sampleRate)
+    : m_fleetFrequencies    ({ { 62.f, 55.f, 49.f, 44.f } }),
+    m_sampleRate            (static_cast<float>(sampleRate)),
+    m_noiseState            (0x1234567u)
+{
+    //convert the patches to per sample coefficients
+    for (auto i = 0u; i < LaneCount; ++i)
+    {
+        const auto& patch = patches[i];
+        m_frequencies[i] = patch.frequency / m_sampleRate;
+        m_parameters.duty[i] = patch.duty;
+        m_parameters.lfoFrequency[i] = patch.lfoFrequency / m_sampleRate;
+        m_parameters.lfoDepth[i] = patch.lfoDepth;
+        m_parameters.sweepDecay[i] = (patch.sweepTime > 0.f) ? std::exp(-1.f / (patch.sweepTime * m_sampleRate)) : 0.f;
+        m_parameters.sweepDepth[i] = patch.sweepDepth;
+        m_parameters.tone[i] = patch.tone;
+        m_parameters.noise[i] = patch.noise;
+        m_parameters.cutoff[i] = getCutoff(patch.cutoff, m_sampleRate);
+        m_parameters.cutoffSweep[i] = getCutoff(patch.cutoff + patch.cutoffSweep, m_sampleRate) - m_parameters.cutoff[i];
+        m_parameters.damping[i] = 1.f / patch.q;
+        m_parameters.lowPass[i] = patch.lowPass;
+        m_parameters.bandPass[i] = patch.bandPass;
+        m_parameters.coupling[i] = 1.f - std::exp(-2.f * pi * couplingFrequency / m_sampleRate);
+        m_parameters.attack[i] = (patch.attackTime > 0.f) ? 1.f - std::exp(-1.f / (patch.attackTime * m_sampleRate)) : 1.f;
+        m_parameters.release[i] = std::exp(-1.f / (patch.releaseTime * m_sampleRate));
+        m_parameters.gain[i] = patch.gain;
+        m_held[i] = patch.held;
+    }
+    reset();
+}
+
+//public
+void Synth::setGate(Sound::ID id, bool on)
+{
+    const auto lane = getCircuit(id);
+    if (lane < 0) return;
+
+    if (m_held[lane])
+    {
+        if (on && m_state.gate[lane] == 0.f)
+        {
+            m_state.frequency[lane] = m_frequencies[lane];
+            m_state.sweep[lane] = 1.f;
+        }
+        m_state.gate[lane] = on ? 1.f : 0.f;
+    }
+    else if (on)
+    {
+        auto frequency = m_frequencies[lane];
+        if (lane == Fleet)
+        {
+            frequency = m_fleetFrequencies[id - Sound::Invader0] / m_sampleRate;
+        }
+        trigger(lane, frequency);
+    }
+}
+
+void Synth::reset()
+{
+    m_state = State();
+}
+
+void Synth::render(std::int32_t* output, std::uint32_t count)
+{
+    //most of the time nothing is playing
+    if (!isActive()) return;
+
+    //the partial sums of each group of four lanes, per sample
+    alignas(16) std::array<float, BlockSize * 4u> mixed;
+
+    while (count > 0)
+    {
+        const auto blockSize = std::min(count, BlockSize);
+
+        //a single noise source feeds all the circuits
+        for (auto i = 0u; i < blockSize; ++i)
+        {
+            m_noiseState ^= m_noiseState << 13;
+            m_noiseState ^= m_noiseState >> 17;
+            m_noiseState ^= m_noiseState << 5;
+            m_noise[i] = static_cast<float>(static_cast<std::int32_t>(m_noiseState)) / 2147483648.f;
+        }
+
+        mixed.fill(0.f);
+        for (auto j = 0u; j < LaneCount; j += 4u)
+        {
+            renderLanes(j, blockSize, mixed.data());
+        }
+
+        for (auto i = 0u; i < blockSize; ++i)
+        {
+            const auto* sums = &mixed[i * 4u];
+            *output++ += static_cast<std::int32_t>((sums[0] + sums[1] + sums[2] + sums[3]) * 32767.f);
+        }
+        count -= blockSize;
+    }
+
+    //let finished circuits go fully silent so rendering can
+    //be skipped entirely, and their filters don't go denormal
+    for (auto j = 0u; j < LaneCount; ++j)
+    {
+        if (m_state.gate[j] == 0.f && m_state.envelope[j] < silence)
+        {
+            m_state.envelope[j] = 0.f;
+            m_state.sweep[j] = 0.f;
+            m_state.low[j] = 0.f;
+            m_state.band[j] = 0.f;
+            m_state.dc[j] = 0.f;
+        }
+    }
+}
+
+//private
+void Synth::renderLanes(std::size_t first, std::uint32_t count, float* mixed)
+{
+    const auto& p = m_parameters;
+    auto& s = m_state;
+
+    const auto zero = Quad::set(0.f);
+    const auto one = Quad::set(1.f);
+    const auto two = Quad::set(2.f);
+    const auto four = Quad::set(4.f);
+    const auto cutoffLimit = Quad::set(maxCutoff);
+
+    const auto duty = Quad::load(&p.duty[first]);
+    const auto lfoFrequency = Quad::load(&p.lfoFrequency[first]);
+    const auto lfoDepth = Quad::load(&p.lfoDepth[first]);
+    const auto sweepDecay = Quad::load(&p.sweepDecay[first]);
+    const auto sweepDepth = Quad::load(&p.sweepDepth[first]);
+    const auto tone = Quad::load(&p.tone[first]);
+    const auto noiseLevel = Quad::load(&p.noise[first]);
+    const auto cutoff = Quad::load(&p.cutoff[first]);
+    const auto cutoffSweep = Quad::load(&p.cutoffSweep[first]);
+    const auto damping = Quad::load(&p.damping[first]);
+    const auto lowPass = Quad::load(&p.lowPass[first]);
+    const auto bandPass = Quad::load(&p.bandPass[first]);
+    const auto coupling = Quad::load(&p.coupling[first]);
+    const auto attack = Quad::load(&p.attack[first]);
+    const auto release = Quad::load(&p.release[first]);
+    const auto gain = Quad::load(&p.gain[first]);
+
+    //the running state stays in registers for the whole block
+    const auto gate = Quad::load(&s.gate[first]);
+    const auto frequency = Quad::load(&s.frequency[first]);
+    auto envelope = Quad::load(&s.envelope[first]);
+    auto phase = Quad::load(&s.phase[first]);
+    auto lfoPhase = Quad::load(&s.lfoPhase[first]);
+    auto sweep = Quad::load(&s.sweep[first]);
+    auto low = Quad::load(&s.low[first]);
+    auto band = Quad::load(&s.band[first]);
+    auto dc = Quad::load(&s.dc[first]);
+
+    for (auto i = 0u; i < count; ++i)
+    {
+        const auto noise = Quad::set(m_noise[i]);
+
+        //the LFO is the triangle across a 555's timing capacitor
+        lfoPhase = lfoPhase + lfoFrequency;
+        lfoPhase = lfoPhase - lessSelect(lfoPhase, one, zero, one);
+        const auto lfo = absolute(lfoPhase * four - two) - one;
+
+        //the sweep capacitor discharges after each trigger, and
+        //along with the LFO sets the VCO's control voltage
+        sweep = sweep * sweepDecay;
+        const auto deviation = one + lfo * lfoDepth + sweep * sweepDepth;
+        phase = phase + maximum(frequency * deviation, zero);
+        phase = phase - lessSelect(phase, one, zero, one);
+
+        const auto pulse = lessSelect(phase, duty, one, zero);
+        const auto input = pulse * tone + noise * noiseLevel;
+
+        //state variable filter, with the cutoff following the sweep
+        const auto f = minimum(cutoff + sweep * cutoffSweep, cutoffLimit);
+        low = low + f * band;
+        const auto high = input - low - damping * band;
+        band = band + f * high;
+        const auto filtered = low * lowPass + band * bandPass;
+
+        //the coupling capacitor removes the pulse's DC level
+        dc = dc + (filtered - dc) * coupling;
+
+        const auto attacked = envelope + (one - envelope) * attack;
+        const auto released = envelope * release;
+        envelope = gate * attacked + (one - gate) * released;
+
+        auto* dst = &mixed[i * 4u];
+        (Quad::load(dst) + (filtered - dc) * envelope * gain).store(dst);
+    }
+
+    envelope.store(&s.envelope[first]);
+    phase.store(&s.phase[first]);
+    lfoPhase.store(&s.lfoPhase[first]);
+    sweep.store(&s.sweep[first]);
+    low.store(&s.low[first]);
+    band.store(&s.band[first]);
+    dc.store(&s.dc[first]);
+}
+
+void Synth::trigger(std::size_t lane, float frequency)
+{
+    m_state.envelope[lane] = 1.f;
+    m_state.frequency[lane] = frequency;
+    m_state.phase[lane] = 0.f;
+    m_state.sweep[lane] = 1.f;
+}
+
+bool Synth::isActive() const
+{
+    for (auto j = 0u; j < LaneCount; ++j)
+    {
+        if (m_state.gate[j] > 0.f || m_state.envelope[j] > 0.f)
+        {
+            return true;
+        }
+    }
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <Trace.hpp>
+
+#ifdef SPIN_TRACING
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    struct Event final
+    {
+        const char* name = nullptr;
+        std::uint64_t start = 0;
+        std::uint64_t duration = 0;
+        std::int32_t value = 0;
+        bool instant = false;
+    };
+
+    //each thread writes only to its own ring, so recording
+    //needs no locks. Once full the oldest events are overwritten
+    class Ring final
+    {
+    public:
+        static constexpr std::size_t Capacity = 65536u; //must be a power of 2
+
+        explicit Ring(std::uint32_t threadID) : m_count(0), m_threadID(threadID) {}
+
+        void push(const Event& evt)
+        {
+            const auto count = m_count.load(std::memory_order_relaxed);
+            m_events[count & (Capacity - 1)] = evt;
+            m_count.store(count + 1, std::memory_order_release);
+        }
+
+        //events being overwritten while this runs may be
+        //torn, which is acceptable for a diagnostic dump
+        template <typename T>
+        void forEach(T func) const
+        {
+            const auto count = m_count.load(std::memory_order_acquire);
+            const auto first = (count > Capacity) ? count - Capacity : 0;
+            for (auto i = first; i < count; ++i)
+            {
+                func(m_events[i & (Capacity - 1)]);
+            }
+        }
+
+        std::uint32_t getThreadID() const { return m_threadID; }
+
+    private:
+        std::array<Event, Capacity> m_events;
+        std::atomic<std::uint64_t> m_count;
+        std::uint32_t m_threadID;
+    };
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    //rings are only registered once per thread, and
+    //live until exit so they can be dumped at any time
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<Ring>> rings;
+
+    Ring& getRing()
+    {
+        thread_local Ring* ring = nullptr;
+        if (!ring)
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            rings.emplace_back(std::make_unique<Ring>(static_cast<std::uint32_t>(rings.size() + 1)));
+            ring = rings.back().get();
+        }
+        return *ring;
+    }
+}
+
+void Trace::span(const char* name, std::uint64_t start, std::uint64_t end)
+{
+    Event evt;
+    evt.name = name;
+    evt.start = start;
+    evt.duration = end - start;
+    getRing().push(evt);
+}
+
+void Trace::instant(const char* name, std::int32_t value)
+{
+    Event evt;
+    evt.name = name;
+    evt.start = now();
+    evt.value = value;
+    evt.instant = true;
+    getRing().push(evt);
+}
+
+std::uint64_t Trace::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+bool Trace::dump(const std::string& path)
+{
+    std::ofstream file(path);
+    if (!file.good()) return false;
+
+    file << "{\"traceEvents\":[\n";
+    bool first = true;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& ring : rings)
+    {
+        const auto tid = ring->getThreadID();
+        ring->forEach([&](const Event& evt)
+        {
+            if (!first) file << ",\n";
+            first = false;
+
+            //timestamps are in microseconds
+            file << "{\"name\":\"" << evt.name << "\",\"pid\":1,\"tid\":" << tid
+                << ",\"ts\":" << (evt.start / 1000) << "." << (evt.start % 1000) / 100;
+            if (evt.instant)
+            {
+                file << ",\"ph\":\"i\",\"s\":\"t\",\"args\":{\"value\":" << evt.value << "}}";
+            }
+            else
+            {
+                file << ",\"ph\":\"X\",\"dur\":" << (evt.duration / 1000) << "." << (evt.duration % 1000) / 100 << "}";
+            }
+        });
+    }
+    file << "\n]}\n";
+
+    return file.good();
+}
+
+#else
+
+void Trace::span(const char*, std::uint64_t, std::uint64_t) {}
+void Trace::instant(const char*, std::int32_t) {}
+std::uint64_t Trace::now() { return 0; }
+bool Trace::dump(const std::string&) { return false; }
+
+#endif //SPIN_TRACING
\ No newline at end of file
@@ -22,10 +22,31 @@ source distribution.
 *********************************************************************/
 
 #include <Machine.hpp>
+#include <Headless.hpp>
+#include <Options.hpp>
 
-int main()
+int main(int argc, char** argv)
 {
-    Machine machine;
+    Options options;
+    if (!options.parse(argc, argv))
+    {
+        Options::printUsage();
+        return 1;
+    }
+
+    if (options.showHelp)
+    {
+        Options::printUsage();
+        return 0;
+    }
+
+    if (options.headless)
+    {
+        Headless headless(options);
+        return headless.run();
+    }
+
+    Machine machine(options);
     machine.run();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,237 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//runs the CP/M CPU exerciser programs (8080PRE, TST8080, CPUTEST,
+//8080EXM) on the bare CPU with just enough of CP/M for them to
+//print their results, then checks them against each program's own
+//success and failure messages and reports how many instructions
+//per second were emulated. The exercisers run
+//billions of instructions so they also serve as a repeatable
+//throughput benchmark for the core.
+//
+//usage: spin_exerciser [--max-cycles <count>] [--no-fusion] <program.COM>
+//
+//the programs can't be distributed so are supplied locally, in
+//tests/cpm, and the test is skipped if they're missing.
+
+#include <I8080/I8080.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace
+{
+    //ctest treats this as a skipped test
+    const int SkipReturnCode = 77;
+
+    //programs are loaded at the start of the CP/M transient program area
+    const Word ProgramAddress = 0x100;
+
+    //a warm boot (jump to 0) ends the program, and calls to the
+    //BDOS at 5 are forwarded through an output port to the handler.
+    //The BDOS address at 6 is also read as the top of usable memory
+    const Word BdosAddress = 0xFE00;
+    const Byte ExitPort = 0xFF;
+    const Byte BdosPort = 0xFE;
+    const Byte PrintChar = 2;
+    const Byte PrintString = 9;
+
+    const std::int32_t SliceCycles = 1000000;
+    const std::uint64_t DefaultMaxCycles = 100000000000ull;
+
+    //a program passes if it prints its success message and none of
+    //its failure message. 8080EXM reports a bad CRC per test but still
+    //prints that the tests are complete, and CPUTEST only reports success
+    struct Expected final
+    {
+        const char* program;
+        const char* success;
+        const char* failure;
+    };
+
+    const Expected ExpectedOutput[] =
+    {
+        { "8080PRE", "8080 Preliminary tests complete", "ERROR" },
+        { "TST8080", "CPU IS OPERATIONAL", "CPU HAS FAILED" },
+        { "CPUTEST", "CPU TESTS OK", nullptr },
+        { "8080EXM", "Tests complete", "ERROR **** crc expected" }
+    };
+
+    struct Machine final
+    {
+        I8080::CPU cpu;
+        I8080::CPU::State state;
+        std::string output;
+        bool finished = false;
+        std::uint64_t instructions = 0;
+        std::chrono::steady_clock::time_point endTime;
+    };
+
+    void print(Machine& machine, char c)
+    {
+        machine.output += c;
+        std::cout << c;
+    }
+
+    //the handlers only receive the accumulator so
+    //the function and its argument are read from the CPU
+    void callBdos(Machine& machine)
+    {
+        const auto& cpu = machine.cpu;
+        switch (cpu.getBC() & 0xFF)
+        {
+        default: break;
+        case PrintChar:
+            print(machine, static_cast<char>(cpu.getDE() & 0xFF));
+            break;
+        case PrintString:
+            for (std::uint32_t i = cpu.getDE(); i < I8080::MEM_SIZE && cpu.readMemory(static_cast<Word>(i)) != '$'; ++i)
+            {
+                print(machine, static_cast<char>(cpu.readMemory(static_cast<Word>(i))));
+            }
+            break;
+        }
+    }
+
+    //the programs are matched by file name, eg tests/cpm/8080EXM.COM
+    const Expected* findExpected(const std::string& path)
+    {
+        auto name = path.substr(path.find_last_of("/\\") + 1);
+        name = name.substr(0, name.find('.'));
+        std::transform(name.begin(), name.end(), name.begin(), [](char c) {return static_cast<char>(std::toupper(c)); });
+
+        for (const auto& expected : ExpectedOutput)
+        {
+            if (name == expected.program)
+            {
+                return &expected;
+            }
+        }
+        return nullptr;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string path;
+    std::uint64_t maxCycles = DefaultMaxCycles;
+    bool fusion = true;
+    for (auto i = 1; i < argc; ++i)
+    {
+        std::string arg(argv[i]);
+        if (arg == "--max-cycles" && i + 1 < argc) maxCycles = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--no-fusion") fusion = false;
+        else path = arg;
+    }
+
+    if (path.empty())
+    {
+        std::cout << "Usage: spin_exerciser [--max-cycles <count>] [--no-fusion] <program.COM>" << std::endl;
+        return 1;
+    }
+
+    if (!std::ifstream(path).good())
+    {
+        std::cout << path << " not found, skipping" << std::endl;
+        return SkipReturnCode;
+    }
+
+    const auto* expected = findExpected(path);
+    if (!expected)
+    {
+        std::cout << path << ": no expected output is known for this program" << std::endl;
+        return 1;
+    }
+
+    //the CPU and snapshot each hold a copy of memory so live on the heap
+    auto machine = std::make_unique<Machine>();
+    auto& cpu = machine->cpu;
+    if (!cpu.loadROM(path, ProgramAddress))
+    {
+        return 1;
+    }
+
+    //patch in the CP/M stub and start the program
+    auto& state = machine->state;
+    cpu.saveState(state);
+    const Byte warmBoot[] = { 0xD3, ExitPort, 0x76 }; //OUT, HLT
+    const Byte bdosVector[] = { 0xC3, BdosAddress & 0xFF, BdosAddress >> 8 }; //JMP
+    const Byte bdos[] = { 0xD3, BdosPort, 0xC9 }; //OUT, RET
+    std::copy(std::begin(warmBoot), std::end(warmBoot), state.memory.begin());
+    std::copy(std::begin(bdosVector), std::end(bdosVector), state.memory.begin() + 5);
+    std::copy(std::begin(bdos), std::end(bdos), state.memory.begin() + BdosAddress);
+    state.programCounter = ProgramAddress;
+    state.stackPointer = BdosAddress;
+    cpu.loadState(state);
+
+    //fusion is on as it is in the emulator, and each program
+    //is also run without it to check the plain handlers
+    cpu.setFeatures(fusion ? static_cast<std::uint32_t>(I8080::CPU::Fusion) : 0u);
+
+    auto* m = machine.get();
+    cpu.setInputHandler([](Byte) {return 0; });
+    cpu.setOutputHandler([m](Byte port, Byte)
+    {
+        if (port == BdosPort)
+        {
+            callBdos(*m);
+        }
+        else if (port == ExitPort && !m->finished)
+        {
+            m->finished = true;
+            m->instructions = m->cpu.getInstructionCount();
+            m->endTime = std::chrono::steady_clock::now();
+        }
+    });
+
+    const auto startTime = std::chrono::steady_clock::now();
+    while (!machine->finished && cpu.getCycleCount() < maxCycles)
+    {
+        cpu.update(SliceCycles);
+    }
+    std::cout << std::endl;
+
+    if (!machine->finished)
+    {
+        std::cout << path << ": FAILED, no warm boot after " << cpu.getCycleCount() << " cycles" << std::endl;
+        return 1;
+    }
+
+    const auto seconds = std::chrono::duration<double>(machine->endTime - startTime).count();
+    const auto mips = (seconds > 0.0) ? (machine->instructions / seconds) / 1000000.0 : 0.0;
+    const auto& output = machine->output;
+    const bool failed = output.find(expected->success) == std::string::npos
+        || (expected->failure && output.find(expected->failure) != std::string::npos);
+
+    std::cout << path << ": " << (failed ? "FAILED" : "passed") << ", "
+        << machine->instructions << " instructions in " << seconds << "s ("
+        << mips << " million instructions per second)" << std::endl;
+    return failed ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,275 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//boots a game headless, drives it with a script of inputs
+//and compares hashes of VRAM at chosen frames against golden
+//values recorded from a known good build.
+//
+//usage: spin_regression [--bless] <script>
+//
+//scripts are plain text, one command per line:
+//  game <name>
+//  press <frame> <input>
+//  release <frame> <input>
+//  hash <frame>
+//
+//the game is loaded from its definition in assets/machines, which
+//also names the inputs
+//
+//golden hashes are stored next to the scripts in ../golden/<name>.txt
+//and are written rather than compared when --bless is given
+
+#include <Board.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    //ctest treats this as a skipped test, eg when ROMs or golden
+    //hashes aren't available
+    const int SkipReturnCode = 77;
+
+    struct Event final
+    {
+        std::uint64_t frame = 0;
+        enum
+        {
+            Press, Release, Hash
+        }type = Hash;
+        std::string input;
+        std::size_t port = 0;
+        Byte bit = 0;
+    };
+
+    struct Script final
+    {
+        std::string game = "invaders";
+        std::vector<Event> events;
+    };
+
+    bool loadScript(const std::string& path, Script& script)
+    {
+        std::ifstream file(path);
+        if (!file.good())
+        {
+            std::cout << "Failed opening script " << path << std::endl;
+            return false;
+        }
+
+        std::string line;
+        std::size_t lineNumber = 0;
+        while (std::getline(file, line))
+        {
+            lineNumber++;
+            line = line.substr(0, line.find('#'));
+
+            std::istringstream ss(line);
+            std::string command;
+            if (!(ss >> command)) continue;
+
+            Event evt;
+            bool valid = false;
+            if (command == "game")
+            {
+                if (ss >> script.game)
+                {
+                    continue;
+                }
+            }
+            else if (command == "press" || command == "release")
+            {
+                //inputs are looked up once the game's definition is loaded
+                if (ss >> evt.frame >> evt.input)
+                {
+                    evt.type = (command == "press") ? Event::Press : Event::Release;
+                    valid = true;
+                }
+            }
+            else if (command == "hash")
+            {
+                evt.type = Event::Hash;
+                valid = static_cast<bool>(ss >> evt.frame);
+            }
+
+            if (!valid)
+            {
+                std::cout << path << ":" << lineNumber << ": invalid command" << std::endl;
+                return false;
+            }
+            script.events.push_back(evt);
+        }
+
+        std::stable_sort(script.events.begin(), script.events.end(),
+            [](const Event& a, const Event& b) {return a.frame < b.frame; });
+        return true;
+    }
+
+    //FNV-1a
+    std::uint64_t hashVRAM(const Byte* vram)
+    {
+        std::uint64_t hash = 0xcbf29ce484222325;
+        for (auto i = 0u; i < I8080::VRAM_SIZE; ++i)
+        {
+            hash ^= vram[i];
+            hash *= 0x100000001b3;
+        }
+        return hash;
+    }
+
+    std::string goldenPath(const std::string& scriptPath)
+    {
+        auto slash = scriptPath.find_last_of("/\\");
+        auto dir = (slash == std::string::npos) ? std::string(".") : scriptPath.substr(0, slash);
+        auto name = (slash == std::string::npos) ? scriptPath : scriptPath.substr(slash + 1);
+        name = name.substr(0, name.find_last_of('.'));
+        return dir + "/../golden/" + name + ".txt";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool bless = false;
+    std::string scriptPath;
+    for (auto i = 1; i < argc; ++i)
+    {
+        std::string arg(argv[i]);
+        if (arg == "--bless") bless = true;
+        else scriptPath = arg;
+    }
+
+    if (scriptPath.empty())
+    {
+        std::cout << "Usage: spin_regression [--bless] <script>" << std::endl;
+        return 1;
+    }
+
+    Script script;
+    if (!loadScript(scriptPath, script))
+    {
+        return 1;
+    }
+
+    Board board;
+    if (!board.loadGame(script.game))
+    {
+        std::cout << "ROMs not found, skipping " << scriptPath << std::endl;
+        return SkipReturnCode;
+    }
+
+    const auto& definition = board.getDefinition();
+    for (auto& evt : script.events)
+    {
+        if (evt.type == Event::Hash) continue;
+
+        const auto* input = definition.findInput(evt.input);
+        if (!input)
+        {
+            std::cout << scriptPath << ": " << definition.getName() << " has no input " << evt.input << std::endl;
+            return 1;
+        }
+        evt.port = input->port;
+        evt.bit = input->bit;
+    }
+
+    //run the script, collecting a hash at each requested frame
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> hashes;
+    for (const auto& evt : script.events)
+    {
+        while (board.getFrameCount() < evt.frame)
+        {
+            board.update();
+        }
+
+        switch (evt.type)
+        {
+        case Event::Press:
+            board.setFlag(evt.port, evt.bit);
+            break;
+        case Event::Release:
+            board.unsetFlag(evt.port, evt.bit);
+            break;
+        case Event::Hash:
+            hashes.emplace_back(evt.frame, hashVRAM(board.getVRAM()));
+            break;
+        }
+    }
+
+    const auto golden = goldenPath(scriptPath);
+    if (bless)
+    {
+        std::ofstream file(golden);
+        for (const auto& h : hashes)
+        {
+            char hex[17];
+            std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(h.second));
+            file << h.first << " " << hex << "\n";
+        }
+        std::cout << "Wrote " << hashes.size() << " hashes to " << golden << std::endl;
+        return file.good() ? 0 : 1;
+    }
+
+    std::ifstream file(golden);
+    if (!file.good())
+    {
+        std::cout << "No golden hashes at " << golden << ", run with --bless to create them" << std::endl;
+        return SkipReturnCode;
+    }
+
+    std::size_t index = 0;
+    std::uint64_t frame = 0;
+    std::string expected;
+    int result = 0;
+    while (file >> frame >> expected)
+    {
+        if (index == hashes.size() || hashes[index].first != frame)
+        {
+            std::cout << "Golden file doesn't match script at frame " << frame << ", re-bless it" << std::endl;
+            return 1;
+        }
+
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hashes[index].second));
+        if (expected != hex)
+        {
+            std::cout << "Frame " << frame << ": expected " << expected << " got " << hex << std::endl;
+            result = 1;
+        }
+        index++;
+    }
+
+    if (index != hashes.size())
+    {
+        std::cout << "Golden file has " << index << " hashes, script has " << hashes.size() << std::endl;
+        result = 1;
+    }
+
+    std::cout << scriptPath << ": " << (result ? "FAILED" : "passed") << std::endl;
+    return result;
+}
@@ -0,0 +1,137 @@
+/*********************************************************************
+Matt Marchant 2016
+http://trederia.blogspot.com
+
+SpIn - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//compares two instruction traces written with --instruction-trace
+//and reports the first instruction at which they differ
+
+#include <I8080/InstructionTrace.hpp>
+#include <I8080/OpInfo.hpp>
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+    const std::size_t maxContext = 64;
+
+    void printRecord(std::uint64_t index, const I8080::TraceRecord& record)
+    {
+        std::printf("%12llu  cycle %12llu  PC %04X  %-12s  A %02X  F %02X  BC %04X  DE %04X  HL %04X  SP %04X\n",
+            static_cast<unsigned long long>(index), static_cast<unsigned long long>(record.cycle),
+            record.programCounter, I8080::opInfo[record.opcode].mnemonic, record.a, record.flags,
+            record.bc, record.de, record.hl, record.stackPointer);
+    }
+
+    std::string getDifferences(const I8080::TraceRecord& a, const I8080::TraceRecord& b)
+    {
+        std::string str;
+        if (a.programCounter != b.programCounter) str += " PC";
+        if (a.opcode != b.opcode) str += " opcode";
+        if (a.a != b.a) str += " A";
+        if (a.flags != b.flags) str += " flags";
+        if (a.bc != b.bc) str += " BC";
+        if (a.de != b.de) str += " DE";
+        if (a.hl != b.hl) str += " HL";
+        if (a.stackPointer != b.stackPointer) str += " SP";
+        if (a.cycle != b.cycle) str += " cycle";
+        return str;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::printf("Usage: spin_tracediff <trace> <trace> [context]\n"
+            "Prints the first instruction at which the traces differ, preceded\n"
+            "by the given number of matching instructions (default 8, max 64)\n");
+        return 2;
+    }
+
+    std::size_t context = 8;
+    if (argc > 3)
+    {
+        context = std::strtoul(argv[3], nullptr, 10);
+        if (context > maxContext) context = maxContext;
+    }
+
+    std::array<I8080::TraceReader, 2> readers;
+    for (auto i = 0u; i < readers.size(); ++i)
+    {
+        if (!readers[i].open(argv[i + 1]))
+        {
+            std::printf("Failed opening trace %s\n", argv[i + 1]);
+            return 2;
+        }
+    }
+
+    //the instructions leading up to a divergence are usually
+    //what's needed to see what caused it
+    std::array<I8080::TraceRecord, maxContext> history;
+    std::uint64_t index = 0;
+
+    I8080::TraceRecord a, b;
+    while (true)
+    {
+        const bool hasA = readers[0].next(a);
+        const bool hasB = readers[1].next(b);
+
+        if (!hasA && !hasB)
+        {
+            std::printf("Traces match, %llu instructions\n", static_cast<unsigned long long>(index));
+            return 0;
+        }
+
+        const bool diverged = (hasA != hasB) || !getDifferences(a, b).empty();
+        if (diverged)
+        {
+            const auto count = (index < context) ? index : context;
+            for (auto i = index - count; i < index; ++i)
+            {
+                printRecord(i, history[i % maxContext]);
+            }
+
+            if (hasA != hasB)
+            {
+                std::printf("%s ends after %llu instructions\n", hasA ? argv[2] : argv[1],
+                    static_cast<unsigned long long>(index));
+                printRecord(index, hasA ? a : b);
+            }
+            else
+            {
+                std::printf("First divergence at instruction %llu, differs in%s\n",
+                    static_cast<unsigned long long>(index), getDifferences(a, b).c_str());
+                std::printf("%s:\n", argv[1]);
+                printRecord(index, a);
+                std::printf("%s:\n", argv[2]);
+                printRecord(index, b);
+            }
+            return 1;
+        }
+
+        history[index % maxContext] = a;
+        index++;
+    }
+}
\ No newline at end of file